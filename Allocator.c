@@ -0,0 +1,96 @@
+/*
+ * StreamLib: Memory allocator hooks
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "Allocator.h"
+
+static _Optional void *std_alloc(size_t const size, void *const ctx)
+{
+  NOT_USED(ctx);
+  return stream_std_malloc(size);
+}
+
+static _Optional void *std_realloc(_Optional void *const ptr,
+                                   size_t const size, void *const ctx)
+{
+  NOT_USED(ctx);
+  return stream_std_realloc(ptr, size);
+}
+
+static void std_free(_Optional void *const ptr, void *const ctx)
+{
+  NOT_USED(ctx);
+  stream_std_free(ptr);
+}
+
+static StreamAllocator const std_allocator = {
+  .alloc_fn = std_alloc,
+  .realloc_fn = std_realloc,
+  .free_fn = std_free,
+  .ctx = NULL,
+};
+
+static StreamAllocator allocator = {
+  .alloc_fn = std_alloc,
+  .realloc_fn = std_realloc,
+  .free_fn = std_free,
+  .ctx = NULL,
+};
+
+StreamAllocator const *stream_std_allocator(void)
+{
+  return &std_allocator;
+}
+
+void stream_set_allocator(_Optional StreamAllocator const *const alloc)
+{
+  if (alloc == NULL) {
+    DEBUGF("Restoring default allocator\n");
+    allocator = std_allocator;
+  } else {
+    assert(alloc->alloc_fn != NULL);
+    assert(alloc->realloc_fn != NULL);
+    assert(alloc->free_fn != NULL);
+    DEBUGF("Installing allocator with context %p\n", alloc->ctx);
+    allocator = *alloc;
+  }
+}
+
+_Optional void *stream_malloc(size_t const n)
+{
+  return allocator.alloc_fn(n, allocator.ctx);
+}
+
+_Optional void *stream_realloc(_Optional void *const p, size_t const n)
+{
+  return allocator.realloc_fn(p, n, allocator.ctx);
+}
+
+void stream_free(_Optional void *const p)
+{
+  allocator.free_fn(p, allocator.ctx);
+}
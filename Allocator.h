@@ -0,0 +1,77 @@
+/*
+ * StreamLib: Memory allocator hooks
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef Allocator_h
+#define Allocator_h
+
+/* ISO library header files */
+#include <stddef.h>
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+typedef _Optional void *StreamAllocFn(size_t size, void *ctx);
+/*
+ * allocates 'size' bytes of memory. 'ctx' is the context pointer
+ * specified in the StreamAllocator object.
+ * Returns: the address of the allocated memory, or null on failure.
+ */
+
+typedef _Optional void *StreamReallocFn(_Optional void *ptr, size_t size,
+                                        void *ctx);
+/*
+ * changes the size of the memory pointed to by 'ptr' (which may be null)
+ * to 'size' bytes, with the same semantics as the standard C library's
+ * realloc function.
+ * Returns: the address of the reallocated memory, or null on failure.
+ */
+
+typedef void StreamFreeFn(_Optional void *ptr, void *ctx);
+/*
+ * frees memory pointed to by 'ptr' (which may be null).
+ */
+
+typedef struct StreamAllocator {
+  StreamAllocFn *alloc_fn;
+  StreamReallocFn *realloc_fn;
+  StreamFreeFn *free_fn;
+  void *ctx;
+} StreamAllocator;
+
+void stream_set_allocator(_Optional StreamAllocator const * /*alloc*/);
+/*
+ * installs a set of functions to be called instead of malloc, realloc
+ * and free for all memory allocated internally by this library, such as
+ * the state of each reader or writer object. The contents of the object
+ * pointed to by 'alloc' are copied. If 'alloc' is null then the standard
+ * C library's functions are used again.
+ * Must not be called while any reader or writer objects exist, because
+ * they would be freed using a different allocator. Memory allocated by
+ * GKeyLib for compressor and decompressor state is not affected.
+ */
+
+#endif /* Allocator_h */
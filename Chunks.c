@@ -0,0 +1,265 @@
+/*
+ * StreamLib: Segmented memory buffer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "Chunks.h"
+
+enum {
+  MinChunkPtrs = 8, /* Initial capacity of the array of chunk pointers */
+};
+
+struct Chunks {
+  size_t chunk_size;
+  size_t nchunks, max_chunks;
+  long int len;
+  _Optional char *_Optional *chunk;
+};
+
+static bool add_chunk(Chunks *const chunks)
+{
+  assert(chunks != NULL);
+  assert(chunks->nchunks <= chunks->max_chunks);
+
+  if (chunks->nchunks == chunks->max_chunks) {
+    /* The array of chunk pointers is small relative to the data, so it
+       doesn't matter that growing it may copy the pointers. */
+    size_t const new_max = chunks->max_chunks ?
+                           chunks->max_chunks * 2 : MinChunkPtrs;
+
+    if (new_max > SIZE_MAX / sizeof(*chunks->chunk)) {
+      DEBUGF("Too many chunks\n");
+      return false;
+    }
+
+    _Optional char *_Optional *const new_chunk =
+      realloc(chunks->chunk, new_max * sizeof(*chunks->chunk));
+
+    if (new_chunk == NULL) {
+      DEBUGF("Failed to extend array of chunks to %zu\n", new_max);
+      return false;
+    }
+    chunks->chunk = new_chunk;
+    chunks->max_chunks = new_max;
+  }
+
+  _Optional char *const chunk = malloc(chunks->chunk_size);
+  if (chunk == NULL) {
+    DEBUGF("Failed to allocate chunk %zu\n", chunks->nchunks);
+    return false;
+  }
+
+  assert(chunks->chunk != NULL);
+  DEBUG_VERBOSEF("Allocated chunk %zu\n", chunks->nchunks);
+  chunks->chunk[chunks->nchunks++] = chunk;
+  return true;
+}
+
+static size_t put(Chunks *const chunks, long int const pos,
+                  _Optional char const *ptr, size_t const size)
+{
+  assert(chunks != NULL);
+  assert(pos >= 0);
+  assert(size <= (unsigned long)LONG_MAX - (unsigned long)pos);
+
+  size_t done = 0;
+  while (done < size) {
+    size_t const offset = (size_t)pos + done,
+                 index = offset / chunks->chunk_size,
+                 chunk_offset = offset % chunks->chunk_size;
+
+    assert(index <= chunks->nchunks);
+    if (index == chunks->nchunks && !add_chunk(chunks)) {
+      break;
+    }
+
+    size_t copy_size = chunks->chunk_size - chunk_offset;
+    if (copy_size > size - done) {
+      copy_size = size - done;
+    }
+
+    assert(chunks->chunk != NULL);
+    _Optional char *const chunk = chunks->chunk[index];
+    assert(chunk != NULL);
+
+    if (ptr) {
+      memcpy(&*chunk + chunk_offset, &*ptr + done, copy_size);
+    } else {
+      memset(&*chunk + chunk_offset, 0, copy_size);
+    }
+    done += copy_size;
+
+    if (offset + copy_size > (unsigned long)chunks->len) {
+      chunks->len = (long)(offset + copy_size);
+    }
+  }
+
+  return done;
+}
+
+_Optional Chunks *chunks_make(size_t const chunk_size)
+{
+  assert(chunk_size > 0);
+
+  _Optional Chunks *const chunks = malloc(sizeof(*chunks));
+  if (chunks == NULL) {
+    DEBUGF("Failed to allocate chunks\n");
+    return NULL;
+  }
+
+  *chunks = (Chunks){
+    .chunk_size = chunk_size,
+    .nchunks = 0,
+    .max_chunks = 0,
+    .len = 0,
+    .chunk = NULL,
+  };
+
+  return chunks;
+}
+
+void chunks_destroy(_Optional Chunks *const chunks)
+{
+  if (chunks != NULL) {
+    for (size_t i = 0; i < chunks->nchunks; ++i) {
+      assert(chunks->chunk != NULL);
+      free(chunks->chunk[i]);
+    }
+    free(chunks->chunk);
+    free(chunks);
+  }
+}
+
+long int chunks_size(Chunks const *const chunks)
+{
+  assert(chunks != NULL);
+  return chunks->len;
+}
+
+size_t chunks_read(Chunks const *const chunks, long int const pos,
+                   void *const ptr, size_t const size)
+{
+  assert(chunks != NULL);
+  assert(pos >= 0);
+  assert(ptr != NULL);
+
+  size_t done = 0;
+  while (done < size) {
+    size_t avail;
+    assert(done <= (unsigned long)LONG_MAX - (unsigned long)pos);
+    _Optional const void *const src =
+      chunks_get(chunks, pos + (long)done, &avail);
+    if (src == NULL) {
+      break;
+    }
+
+    size_t const copy_size = avail > size - done ? size - done : avail;
+    memcpy((char *)ptr + done, &*(const char *)src, copy_size);
+    done += copy_size;
+  }
+
+  return done;
+}
+
+size_t chunks_write(Chunks *const chunks, long int const pos,
+                    void const *const ptr, size_t const size)
+{
+  assert(chunks != NULL);
+  assert(pos >= 0);
+  assert(ptr != NULL);
+
+  if (pos > chunks->len) {
+    /* To simulate a sparse file, zero-initialize skipped bytes. */
+    long int const bytes_to_skip = pos - chunks->len;
+    DEBUGF("Zeroing %ld bytes at offset %ld\n", bytes_to_skip, chunks->len);
+
+    if (put(chunks, chunks->len, NULL, (size_t)bytes_to_skip) !=
+        (size_t)bytes_to_skip) {
+      return 0;
+    }
+  }
+
+  return put(chunks, pos, ptr, size);
+}
+
+_Optional const void *chunks_get(Chunks const *const chunks,
+                                 long int const pos, size_t *const size)
+{
+  assert(chunks != NULL);
+  assert(pos >= 0);
+  assert(size != NULL);
+
+  if (pos >= chunks->len) {
+    *size = 0;
+    return NULL;
+  }
+
+  size_t const index = (size_t)pos / chunks->chunk_size,
+               chunk_offset = (size_t)pos % chunks->chunk_size;
+  assert(index < chunks->nchunks);
+
+  /* The last chunk may be only partly used */
+  size_t avail = chunks->chunk_size - chunk_offset;
+  if ((unsigned long)(chunks->len - pos) < avail) {
+    avail = (size_t)(chunks->len - pos);
+  }
+  *size = avail;
+
+  assert(chunks->chunk != NULL);
+  _Optional char *const chunk = chunks->chunk[index];
+  assert(chunk != NULL);
+  return &*chunk + chunk_offset;
+}
+
+bool chunks_flatten(Chunks const *const chunks, _Optional void **const buffer)
+{
+  assert(chunks != NULL);
+  assert(buffer != NULL);
+
+  assert((unsigned long)chunks->len <= SIZE_MAX);
+  size_t const size = (size_t)chunks->len;
+  if (size == 0) {
+    *buffer = NULL;
+    return true;
+  }
+
+  /* The caller frees this buffer, so use the standard C library. */
+  _Optional void *const flat = stream_std_malloc(size);
+  if (flat == NULL) {
+    DEBUGF("Failed to allocate %zu bytes to flatten chunks\n", size);
+    return false;
+  }
+
+  size_t const n = chunks_read(chunks, 0, &*(char *)flat, size);
+  assert(n == size);
+  NOT_USED(n);
+  *buffer = flat;
+  return true;
+}
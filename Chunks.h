@@ -0,0 +1,104 @@
+/*
+ * StreamLib: Segmented memory buffer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef Chunks_h
+#define Chunks_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+typedef struct Chunks Chunks;
+
+_Optional Chunks *chunks_make(size_t /*chunk_size*/);
+/*
+ * creates an empty buffer which is stored as a list of separately
+ * allocated chunks, each of which is 'chunk_size' bytes long. Unlike a
+ * contiguous buffer, it can grow without moving or copying data that
+ * was already stored in it.
+ * Returns: the address of the new object, or null if there was not
+ *          enough free memory.
+ */
+
+void chunks_destroy(_Optional Chunks * /*chunks*/);
+/*
+ * destroys a segmented buffer, freeing all of its chunks. Must not be
+ * called whilst any reader or writer objects are using it.
+ */
+
+long int chunks_size(Chunks const * /*chunks*/);
+/*
+ * gets the number of bytes stored in a segmented buffer, which is one
+ * beyond the highest offset at which a byte has been written.
+ * Returns: the size of the stored data.
+ */
+
+size_t chunks_read(Chunks const * /*chunks*/, long int /*pos*/,
+                   void * /*ptr*/, size_t /*size*/);
+/*
+ * copies up to 'size' bytes, starting at offset 'pos' within a segmented
+ * buffer, to the array pointed to by 'ptr'. Fewer bytes are copied if
+ * the end of the stored data is reached first.
+ * Returns: the number of bytes copied.
+ */
+
+size_t chunks_write(Chunks * /*chunks*/, long int /*pos*/,
+                    void const * /*ptr*/, size_t /*size*/);
+/*
+ * copies 'size' bytes from the array pointed to by 'ptr' to offset 'pos'
+ * within a segmented buffer, allocating new chunks as necessary. If 'pos'
+ * is beyond the end of the stored data then the gap is filled with zeros.
+ * Returns: the number of bytes copied, which may be fewer than specified
+ *          if there was not enough free memory.
+ */
+
+_Optional const void *chunks_get(Chunks const * /*chunks*/,
+                                 long int /*pos*/, size_t * /*size*/);
+/*
+ * gets the address of the byte stored at offset 'pos' within a segmented
+ * buffer, and stores the number of bytes that can be read contiguously
+ * from that address in the object pointed to by 'size'. This allows a
+ * chunk's contents to be used without copying them.
+ * Returns: the address of the byte at the given offset, or null if 'pos'
+ *          is not less than the size of the stored data.
+ */
+
+bool chunks_flatten(Chunks const * /*chunks*/, _Optional void ** /*buffer*/);
+/*
+ * copies all of the data stored in a segmented buffer to a contiguous
+ * buffer allocated by calling malloc, and stores its address in the
+ * object pointed to by 'buffer'. The size of the new buffer is given by
+ * chunks_size. It is the caller's responsibility to free it by calling
+ * free. If the segmented buffer is empty then null may be stored.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* Chunks_h */
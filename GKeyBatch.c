@@ -0,0 +1,388 @@
+/*
+ * StreamLib: Batch Gordon Key (de)compression on a thread pool
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added gkey_batch_estimate and gkey_batch_compress.
+                  Threads are enabled by the STREAM_THREADS feature macro.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef STREAM_THREADS
+/* POSIX header files */
+#include <pthread.h>
+#include <unistd.h>
+#define BATCH_THREADS
+#endif
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "GKeyBatch.h"
+#include "ReaderGKey.h"
+#include "StreamCopy.h"
+#include "WriterGKC.h"
+#include "WriterGKey.h"
+#include "WriterNull.h"
+
+enum {
+  MaxThreads = 64,
+};
+
+struct BatchWorker;
+
+typedef bool BatchRunFn(struct BatchWorker *worker, size_t index);
+
+typedef struct {
+  void *jobs;
+  size_t njobs;
+  BatchRunFn *run;
+  size_t next; /* index of the next job to start */
+  size_t ndone, nsucceeded;
+  _Optional GKeyBatchProgressFn *progress;
+  void *arg;
+#ifdef BATCH_THREADS
+  pthread_mutex_t mutex; /* protects ndone, nsucceeded and progress calls */
+#endif
+} Batch;
+
+typedef struct BatchWorker {
+  Batch *batch;
+  Reader reader;          /* decompressor, if has_reader */
+  Writer writer;          /* compressor, if has_writer */
+  Writer null;            /* attached to the compressor between jobs */
+  bool has_reader, has_writer;
+  unsigned int reader_log_2, writer_log_2;
+} BatchWorker;
+
+static size_t take_job(Batch *const batch)
+{
+  assert(batch != NULL);
+#ifdef BATCH_THREADS
+  return __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+#else
+  return batch->next++;
+#endif
+}
+
+static void finish_job(Batch *const batch, bool const success)
+{
+  assert(batch != NULL);
+#ifdef BATCH_THREADS
+  pthread_mutex_lock(&batch->mutex);
+#endif
+  ++batch->ndone;
+  if (success) {
+    ++batch->nsucceeded;
+  }
+  if (batch->progress) {
+    batch->progress(batch->ndone, batch->njobs, batch->arg);
+  }
+#ifdef BATCH_THREADS
+  pthread_mutex_unlock(&batch->mutex);
+#endif
+}
+
+static bool get_reader(BatchWorker *const worker, GKeyBatchJob *const job)
+{
+  assert(worker != NULL);
+  assert(job != NULL);
+
+  /* Reuse the decompressor if possible */
+  if (worker->has_reader) {
+    if (worker->reader_log_2 == job->history_log_2) {
+      reader_gkey_reinit_from(&worker->reader, job->in);
+      return true;
+    }
+    reader_destroy(&worker->reader);
+    worker->has_reader = false;
+  }
+
+  if (!reader_gkey_init_from(&worker->reader, job->history_log_2, job->in)) {
+    DEBUGF("Failed to create a reader\n");
+    return false;
+  }
+  worker->has_reader = true;
+  worker->reader_log_2 = job->history_log_2;
+  return true;
+}
+
+static bool decompress(BatchWorker *const worker, size_t const index)
+{
+  assert(worker != NULL);
+  assert(worker->batch != NULL);
+  GKeyBatchJob *const job = (GKeyBatchJob *)worker->batch->jobs + index;
+  assert(job->in != NULL);
+  assert(job->out != NULL);
+
+  job->result = -1;
+  if (reader_ferror(job->in) || reader_feof(job->in) ||
+      writer_ferror(job->out) || !get_reader(worker, job)) {
+    return false;
+  }
+
+  long int const n = stream_copy(&worker->reader, job->out, -1);
+  if (reader_ferror(&worker->reader) || writer_ferror(job->out)) {
+    DEBUGF("Failed to decompress after %ld bytes\n", n);
+    return false;
+  }
+
+  job->result = n;
+  return true;
+}
+
+static bool get_writer(BatchWorker *const worker,
+                       GKeyBatchCompJob *const job)
+{
+  assert(worker != NULL);
+  assert(job != NULL);
+
+  /* Reuse the compressor if possible. The previous job was finished by
+     attaching a null writer, so there is no output to lose. */
+  if (worker->has_writer) {
+    if (worker->writer_log_2 == job->history_log_2) {
+      writer_gkey_reinit_from(&worker->writer, 0, job->out);
+      return true;
+    }
+    writer_destroy(&worker->writer);
+    worker->has_writer = false;
+  }
+
+  if (!writer_gkey_init_from(&worker->writer, job->history_log_2, 0,
+                             job->out)) {
+    DEBUGF("Failed to create a writer\n");
+    return false;
+  }
+  worker->has_writer = true;
+  worker->writer_log_2 = job->history_log_2;
+  return true;
+}
+
+static bool compress(BatchWorker *const worker, size_t const index)
+{
+  assert(worker != NULL);
+  assert(worker->batch != NULL);
+  GKeyBatchCompJob *const job = (GKeyBatchCompJob *)worker->batch->jobs +
+                                index;
+  assert(job->in != NULL);
+  assert(job->out != NULL);
+
+  job->result = -1;
+  if (reader_ferror(job->in) || writer_ferror(job->out) ||
+      !get_writer(worker, job)) {
+    return false;
+  }
+
+  long int const n = stream_copy(job->in, &worker->writer, -1);
+
+  /* Finish the output without destroying the compressor */
+  writer_null_init(&worker->null);
+  long int const len =
+    writer_gkey_reinit_from(&worker->writer, 0, &worker->null);
+
+  if (len < 0 || reader_ferror(job->in)) {
+    DEBUGF("Failed to compress after %ld bytes\n", n);
+    return false;
+  }
+
+  assert(len == n);
+  job->result = len;
+  return true;
+}
+
+static bool estimate(BatchWorker *const worker, size_t const index)
+{
+  assert(worker != NULL);
+  assert(worker->batch != NULL);
+  GKeyBatchCompJob *const job = (GKeyBatchCompJob *)worker->batch->jobs +
+                                index;
+  assert(job->in != NULL);
+
+  job->estimate = -1;
+  long int const start = reader_ftell(job->in);
+  if (start < 0 || reader_ferror(job->in)) {
+    return false;
+  }
+
+  Writer gkc;
+  long int out_size;
+  if (!writer_gkc_init(&gkc, job->history_log_2, &out_size)) {
+    DEBUGF("Failed to create an estimator\n");
+    return false;
+  }
+
+  stream_copy(job->in, &gkc, -1);
+  bool const read_ok = !reader_ferror(job->in);
+  if (writer_destroy(&gkc) < 0 || !read_ok) {
+    return false;
+  }
+
+  /* Allow the input to be read again by gkey_batch_compress */
+  if (reader_fseek(job->in, start, SEEK_SET)) {
+    return false;
+  }
+
+  job->estimate = out_size;
+  return true;
+}
+
+static void *work(void *const arg)
+{
+  BatchWorker *const worker = arg;
+  assert(worker != NULL);
+  Batch *const batch = worker->batch;
+  assert(batch != NULL);
+
+  for (size_t i = take_job(batch); i < batch->njobs; i = take_job(batch)) {
+    finish_job(batch, batch->run(worker, i));
+  }
+
+  if (worker->has_reader) {
+    reader_destroy(&worker->reader);
+    worker->has_reader = false;
+  }
+  if (worker->has_writer) {
+    writer_destroy(&worker->writer);
+    worker->has_writer = false;
+  }
+  return NULL;
+}
+
+#ifdef BATCH_THREADS
+static unsigned int count_threads(unsigned int nthreads, size_t const njobs)
+{
+  if (nthreads == 0) {
+    long int const nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nproc > MaxThreads) {
+      nthreads = MaxThreads;
+    } else {
+      nthreads = nproc > 0 ? (unsigned int)nproc : 1;
+    }
+  }
+
+  if (nthreads > MaxThreads) {
+    nthreads = MaxThreads;
+  }
+
+  if (nthreads > njobs) {
+    nthreads = njobs > 0 ? (unsigned int)njobs : 1;
+  }
+  return nthreads;
+}
+#endif
+
+static size_t run_batch(void *const jobs, size_t const njobs,
+                        BatchRunFn *const run, unsigned int const nthreads,
+                        _Optional GKeyBatchProgressFn *const progress,
+                        void *const arg)
+{
+  assert(jobs != NULL || njobs == 0);
+  assert(run != NULL);
+
+  Batch batch = {
+    .jobs = jobs,
+    .njobs = njobs,
+    .run = run,
+    .next = 0,
+    .ndone = 0,
+    .nsucceeded = 0,
+    .progress = progress,
+    .arg = arg,
+  };
+
+  BatchWorker workers[MaxThreads];
+  unsigned int nworkers = 1;
+
+#ifdef BATCH_THREADS
+  if (pthread_mutex_init(&batch.mutex, NULL)) {
+    DEBUGF("Failed to create mutex\n");
+    return 0;
+  }
+
+  unsigned int const nwanted = count_threads(nthreads, njobs);
+  pthread_t threads[MaxThreads];
+#else
+  NOT_USED(nthreads);
+#endif
+
+  workers[0] = (BatchWorker){.batch = &batch};
+
+#ifdef BATCH_THREADS
+  /* The calling thread is the first worker */
+  for (; nworkers < nwanted; ++nworkers) {
+    workers[nworkers] = (BatchWorker){.batch = &batch};
+    if (pthread_create(&threads[nworkers], NULL, work, &workers[nworkers])) {
+      DEBUGF("Only created %u of %u threads\n", nworkers, nwanted);
+      break;
+    }
+  }
+  DEBUGF("Running %zu jobs on %u threads\n", njobs, nworkers);
+#endif
+
+  work(&workers[0]);
+
+#ifdef BATCH_THREADS
+  for (unsigned int i = 1; i < nworkers; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&batch.mutex);
+#else
+  NOT_USED(nworkers);
+#endif
+
+  assert(batch.ndone == njobs);
+  DEBUGF("%zu of %zu jobs succeeded\n", batch.nsucceeded, njobs);
+  return batch.nsucceeded;
+}
+
+size_t gkey_batch_decompress(GKeyBatchJob *const jobs, size_t const njobs,
+                             unsigned int const nthreads,
+                             _Optional GKeyBatchProgressFn *const progress,
+                             void *const arg)
+{
+  for (size_t i = 0; i < njobs; ++i) {
+    jobs[i].result = -1;
+  }
+  return run_batch(jobs, njobs, decompress, nthreads, progress, arg);
+}
+
+size_t gkey_batch_estimate(GKeyBatchCompJob *const jobs, size_t const njobs,
+                           unsigned int const nthreads,
+                           _Optional GKeyBatchProgressFn *const progress,
+                           void *const arg)
+{
+  for (size_t i = 0; i < njobs; ++i) {
+    jobs[i].estimate = -1;
+  }
+  return run_batch(jobs, njobs, estimate, nthreads, progress, arg);
+}
+
+size_t gkey_batch_compress(GKeyBatchCompJob *const jobs, size_t const njobs,
+                           unsigned int const nthreads,
+                           _Optional GKeyBatchProgressFn *const progress,
+                           void *const arg)
+{
+  for (size_t i = 0; i < njobs; ++i) {
+    jobs[i].result = -1;
+  }
+  return run_batch(jobs, njobs, compress, nthreads, progress, arg);
+}
@@ -0,0 +1,119 @@
+/*
+ * StreamLib: Batch Gordon Key (de)compression on a thread pool
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library, POSIX threads (optional).
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added gkey_batch_estimate and gkey_batch_compress.
+*/
+
+#ifndef GKeyBatch_h
+#define GKeyBatch_h
+
+/* ISO library header files */
+#include <stddef.h>
+
+/* Local header files */
+#include "Reader.h"
+#include "Writer.h"
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+typedef struct {
+  Reader *in;                 /* compressed input */
+  Writer *out;                /* destination for the decompressed data */
+  unsigned int history_log_2; /* as for reader_gkey_init */
+  long int result;            /* decompressed size, or -1 on failure */
+} GKeyBatchJob;
+
+typedef struct {
+  Reader *in;                 /* uncompressed input */
+  Writer *out;                /* destination for the compressed data */
+  unsigned int history_log_2; /* as for writer_gkey_init */
+  long int estimate;          /* compressed size, or -1 if not estimated */
+  long int result;            /* uncompressed size, or -1 on failure */
+} GKeyBatchCompJob;
+
+typedef void GKeyBatchProgressFn(size_t /*ndone*/, size_t /*njobs*/,
+                                 void * /*arg*/);
+/*
+ * type of function called after each job in a batch has finished, with the
+ * number of jobs finished so far and the total number of jobs. Calls are
+ * never concurrent but may be made from any thread.
+ */
+
+size_t gkey_batch_decompress(GKeyBatchJob * /*jobs*/, size_t /*njobs*/,
+                             unsigned int /*nthreads*/,
+                             _Optional GKeyBatchProgressFn * /*progress*/,
+                             void * /*arg*/);
+/*
+ * decompresses data in Gordon Key's compressed format from the reader
+ * object of each of 'njobs' jobs in the array pointed to by 'jobs' to
+ * the writer object of the same job, starting from their current file
+ * positions. Jobs are shared between up to 'nthreads' threads (including
+ * the calling thread), each taking the next unstarted job as soon as it
+ * finishes one; 0 means one thread per online processor. Each thread
+ * reuses one decompressor for all of its jobs. The reader and writer
+ * objects of different jobs must be independent, because they may be used
+ * concurrently. The 'result' member of each job is set to the number of
+ * bytes written, or -1 if the input was invalid or an error occurred.
+ * If 'progress' is not null then it is called with 'arg' after each job.
+ * Threads are only used on POSIX systems; otherwise the jobs are done in
+ * order by the calling thread.
+ * Returns: the number of jobs that succeeded.
+ */
+
+size_t gkey_batch_estimate(GKeyBatchCompJob * /*jobs*/, size_t /*njobs*/,
+                           unsigned int /*nthreads*/,
+                           _Optional GKeyBatchProgressFn * /*progress*/,
+                           void * /*arg*/);
+/*
+ * predicts the size of the data that gkey_batch_compress would write for
+ * each of 'njobs' jobs in the array pointed to by 'jobs', in the same way
+ * as writer_gkc_init, so that their outputs can be allocated beforehand.
+ * The input of each job is read from its current file position to the
+ * end, then returned to that position, so it must be seekable. The
+ * 'estimate' member of each job is set to the predicted size (including
+ * the header), or -1 on failure. The writer objects are not used. Jobs
+ * are shared between threads as for gkey_batch_decompress.
+ * Returns: the number of jobs that succeeded.
+ */
+
+size_t gkey_batch_compress(GKeyBatchCompJob * /*jobs*/, size_t /*njobs*/,
+                           unsigned int /*nthreads*/,
+                           _Optional GKeyBatchProgressFn * /*progress*/,
+                           void * /*arg*/);
+/*
+ * compresses data from the reader object of each of 'njobs' jobs in the
+ * array pointed to by 'jobs', from its current file position to the end,
+ * and writes it in Gordon Key's compressed format to the writer object of
+ * the same job, as if by writer_gkey_init_from. Each writer must be at
+ * the start of its output and able to seek back to rewrite the header.
+ * Jobs are shared between threads as for gkey_batch_decompress, and each
+ * thread reuses one compressor for all of its jobs. The 'result' member
+ * of each job is set to the number of bytes compressed, or -1 if an error
+ * occurred.
+ * Returns: the number of jobs that succeeded.
+ */
+
+#endif /* GKeyBatch_h */
@@ -0,0 +1,240 @@
+/*
+ * StreamLib: Whole-buffer Gordon Key compression
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Recognise the extended header when decompressing.
+                  gkey_decompress_alloc ignores stream_set_allocator.
+                  Parse the header with gkey_hdr_parse.
+*/
+
+/* ISO library header files */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* GKey library files */
+#include "GKeyComp.h"
+#include "GKeyDecomp.h"
+
+/* Local headers */
+#include "Internal/GKeyHdr.h"
+#include "Internal/StreamMisc.h"
+#include "GKeyBuf.h"
+
+enum {
+  HeaderSize = GKeyHdr_ClassicSize, /* Decompressed size as a 32-bit
+                                       little-endian integer */
+};
+
+static void put_hdr(unsigned char *const out, uint32_t const val)
+{
+  assert(out != NULL);
+  for (size_t i = 0; i < HeaderSize; ++i) {
+    out[i] = (unsigned char)(val >> (CHAR_BIT * i));
+  }
+}
+
+static long int parse_hdr(unsigned char const *const in,
+                          size_t const in_size, size_t *const hdr_size)
+{
+  assert(in != NULL || in_size == 0);
+  assert(hdr_size != NULL);
+
+  GKeyHdrInfo info;
+  if (!gkey_hdr_parse(in, in_size, &info)) {
+    DEBUGF("Bad or truncated header in %zu bytes\n", in_size);
+    return -1;
+  }
+
+  /* Members aren't supported */
+  if (info.member) {
+    DEBUGF("Can't decompress a multi-member stream\n");
+    return -1;
+  }
+
+  if (info.out_len > LONG_MAX) {
+    DEBUGF("Size %" PRIu64 " in compressed data is too big\n", info.out_len);
+    return -1;
+  }
+
+  *hdr_size = info.hdr_size;
+  return (long)info.out_len;
+}
+
+size_t gkey_compress_bound(size_t const in_size)
+{
+  /* Each literal byte is preceded by a flag bit */
+  size_t const flag_bytes = in_size / CHAR_BIT +
+                            (in_size % CHAR_BIT ? 1 : 0);
+
+  if (in_size > SIZE_MAX - flag_bytes - HeaderSize) {
+    DEBUGF("Bound for %zu bytes is too big\n", in_size);
+    return 0;
+  }
+  return HeaderSize + in_size + flag_bytes;
+}
+
+long int gkey_compress_buffer(unsigned int const history_log_2,
+                              void const *const in, size_t const in_size,
+                              void *const out, size_t const out_size)
+{
+  assert(in != NULL || in_size == 0);
+  assert(out != NULL);
+
+  if (in_size > INT32_MAX) {
+    DEBUGF("Bad uncompressed size %zu\n", in_size);
+    return -1;
+  }
+
+  if (out_size < HeaderSize) {
+    DEBUGF("No room for header\n");
+    return -1;
+  }
+
+  _Optional GKeyComp *const comp = gkeycomp_make(history_log_2);
+  if (comp == NULL) {
+    DEBUGF("Failed to create compressor\n");
+    return -1;
+  }
+
+  put_hdr(out, (uint32_t)in_size);
+
+  size_t const max = out_size - HeaderSize < LONG_MAX - HeaderSize ?
+                     out_size - HeaderSize : LONG_MAX - HeaderSize;
+
+  GKeyParameters params = {
+    .in_buffer = in,
+    .in_size = in_size,
+    .out_buffer = (unsigned char *)out + HeaderSize,
+    .out_size = max,
+    .prog_cb = (GKeyProgressFn *)NULL,
+    .cb_arg = NULL,
+  };
+
+  /* Compress all of the input, then keep going with no input until
+     the compressor has flushed its output. */
+  GKeyStatus status;
+  do {
+    status = gkeycomp_compress(&*comp, &params);
+    assert(status == GKeyStatus_OK || status == GKeyStatus_BufferOverflow ||
+           status == GKeyStatus_Finished);
+  } while (status == GKeyStatus_OK);
+
+  gkeycomp_destroy(comp);
+
+  if (status != GKeyStatus_Finished) {
+    DEBUGF("Output buffer of %zu bytes is too small\n", out_size);
+    return -1;
+  }
+
+  long int const len = HeaderSize + (long)(max - params.out_size);
+  DEBUGF("Compressed %zu bytes to %ld\n", in_size, len);
+  return len;
+}
+
+long int gkey_decompressed_size(void const *const in, size_t const in_size)
+{
+  size_t hdr_size;
+  return parse_hdr(in, in_size, &hdr_size);
+}
+
+long int gkey_decompress_buffer(unsigned int const history_log_2,
+                                void const *const in, size_t const in_size,
+                                void *const out, size_t const out_size)
+{
+  assert(out != NULL || out_size == 0);
+
+  size_t hdr_size;
+  long int const len = parse_hdr(in, in_size, &hdr_size);
+  if (len < 0) {
+    return -1;
+  }
+
+  if ((unsigned long)len > out_size) {
+    DEBUGF("Output buffer of %zu bytes is too small for %ld\n", out_size,
+           len);
+    return -1;
+  }
+
+  if (len == 0) {
+    return 0;
+  }
+
+  _Optional GKeyDecomp *const decomp = gkeydecomp_make(history_log_2);
+  if (decomp == NULL) {
+    DEBUGF("Failed to create decompressor\n");
+    return -1;
+  }
+
+  GKeyParameters params = {
+    .in_buffer = (unsigned char const *)in + hdr_size,
+    .in_size = in_size - hdr_size,
+    .out_buffer = out,
+    .out_size = (size_t)len,
+    .prog_cb = (GKeyProgressFn *)NULL,
+    .cb_arg = NULL,
+  };
+
+  GKeyStatus const status = gkeydecomp_decompress(&*decomp, &params);
+  gkeydecomp_destroy(decomp);
+
+  /* Like reader_gkey_init, ignore any input beyond the advertised size */
+  if ((status != GKeyStatus_OK && status != GKeyStatus_BufferOverflow) ||
+      params.out_size != 0) {
+    DEBUGF("Compressed data is bad or truncated (status %d)\n", status);
+    return -1;
+  }
+
+  DEBUGF("Decompressed %zu bytes to %ld\n", in_size, len);
+  return len;
+}
+
+_Optional void *gkey_decompress_alloc(unsigned int const history_log_2,
+                                      void const *const in,
+                                      size_t const in_size,
+                                      size_t *const out_size)
+{
+  assert(out_size != NULL);
+
+  *out_size = 0;
+  long int const len = gkey_decompressed_size(in, in_size);
+  if (len < 0) {
+    return NULL;
+  }
+
+  /* Avoid a null result for empty data. The caller frees this buffer,
+     so use the standard C library. */
+  _Optional void *const out = stream_std_malloc(len > 0 ? (size_t)len : 1);
+  if (out == NULL) {
+    DEBUGF("Failed to allocate %ld bytes\n", len);
+    return NULL;
+  }
+
+  if (gkey_decompress_buffer(history_log_2, in, in_size, (void *)out,
+                             (size_t)len) != len) {
+    stream_std_free(out);
+    return NULL;
+  }
+
+  *out_size = (size_t)len;
+  return out;
+}
@@ -0,0 +1,107 @@
+/*
+ * StreamLib: Whole-buffer Gordon Key compression
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library, GKey library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Recognise the extended header when decompressing.
+                  gkey_decompress_alloc ignores stream_set_allocator.
+*/
+
+#ifndef GKeyBuf_h
+#define GKeyBuf_h
+
+/* ISO library header files */
+#include <stddef.h>
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+size_t gkey_compress_bound(size_t /*in_size*/);
+/*
+ * gets the maximum size of the output of gkey_compress_buffer for 'in_size'
+ * bytes of input, including the header. This allows for every byte being
+ * encoded as a literal, which costs one extra bit.
+ * Returns: the worst-case size of the compressed data, or 0 if it
+ *          is too large to be represented.
+ */
+
+long int gkey_compress_buffer(unsigned int /*history_log_2*/,
+                              void const * /*in*/, size_t /*in_size*/,
+                              void * /*out*/, size_t /*out_size*/);
+/*
+ * encodes 'in_size' bytes of data from the array pointed to by 'in' in
+ * Gordon Key's compressed format, with a header in the same format as
+ * that written by writer_gkey_init, and stores the result in the array
+ * of 'out_size' bytes pointed to by 'out'. The whole input is compressed
+ * in one call without any intermediate buffering. An output size of at
+ * least gkey_compress_bound(in_size) is always sufficient. The
+ * 'history_log_2' parameter is the number of bytes to look behind, in
+ * base 2 logarithmic form.
+ * Returns: the size of the compressed data if successful, otherwise -1.
+ *          Fails if the output array is too small, the input is too big
+ *          to be represented in the header, or there is not enough free
+ *          memory.
+ */
+
+long int gkey_decompressed_size(void const * /*in*/, size_t /*in_size*/);
+/*
+ * gets the size of the data encoded in Gordon Key's compressed format in
+ * the array of 'in_size' bytes pointed to by 'in', from its header.
+ * Both the classic and extended headers (see writer_gkey_set_extended)
+ * are recognised here and by the functions below, but multi-member
+ * streams (see writer_gkey_set_members) are not.
+ * Returns: the size of the decompressed data, or -1 if the header is
+ *          missing or invalid.
+ */
+
+long int gkey_decompress_buffer(unsigned int /*history_log_2*/,
+                                void const * /*in*/, size_t /*in_size*/,
+                                void * /*out*/, size_t /*out_size*/);
+/*
+ * decodes 'in_size' bytes of data in Gordon Key's compressed format
+ * (including its header) from the array pointed to by 'in' and stores
+ * the result in the array of 'out_size' bytes pointed to by 'out'. The
+ * output size must be at least gkey_decompressed_size(in, in_size). The
+ * whole input is decompressed in one call without any intermediate
+ * buffering. The 'history_log_2' parameter must be the same as that used
+ * to compress the data.
+ * Returns: the size of the decompressed data if successful, otherwise -1.
+ *          Fails if the output array is too small, the input is invalid
+ *          or truncated, or there is not enough free memory.
+ */
+
+_Optional void *gkey_decompress_alloc(unsigned int /*history_log_2*/,
+                                      void const * /*in*/, size_t /*in_size*/,
+                                      size_t * /*out_size*/);
+/*
+ * decodes data in the same way as gkey_decompress_buffer except that the
+ * output array is allocated by calling malloc (regardless of any allocator
+ * installed by stream_set_allocator), with exactly the size stored in the
+ * header. The size of the decompressed data is stored in the
+ * object pointed to by 'out_size'. It is the caller's responsibility to
+ * free the array.
+ * Returns: the address of the decompressed data if successful, otherwise
+ *          null.
+ */
+
+#endif /* GKeyBuf_h */
@@ -0,0 +1,529 @@
+/*
+ * StreamLib: Process-wide cache of decompressed files
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Enabled by the STREAM_THREADS feature macro.
+                  Include nanoseconds in the modification time.
+                  Cache files with extended or member headers.
+*/
+
+#ifdef STREAM_THREADS
+/* Required for fileno and st_mtim */
+#define _POSIX_C_SOURCE 200809L
+#ifdef __APPLE__
+/* Required for st_mtimespec, which is macOS's name for st_mtim */
+#define _DARWIN_C_SOURCE
+#endif
+#endif
+
+/* ISO library header files */
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef STREAM_THREADS
+/* POSIX header files */
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#define FILE_CACHE
+#ifdef __APPLE__
+#define MTIME_NSEC(st) ((st).st_mtimespec.tv_nsec)
+#else
+#define MTIME_NSEC(st) ((st).st_mtim.tv_nsec)
+#endif
+#endif
+
+/* Local headers */
+#include "Internal/GKeyHdr.h"
+#include "Internal/StreamMisc.h"
+#include "GKeyCache.h"
+#include "ReaderGKey.h"
+
+#ifdef FILE_CACHE
+
+enum {
+  MinCapacity = 4096, /* smallest size to which a cache entry grows */
+};
+
+typedef struct {
+  dev_t dev;
+  ino_t ino;
+  time_t mtime;
+  long int mtime_nsec;
+  off_t size;
+  long int offset;
+  unsigned int history_log_2;
+} CacheKey;
+
+typedef struct CacheEntry {
+  _Optional struct CacheEntry *prev, *next; /* most recent first */
+  CacheKey key;
+  size_t len;
+  unsigned long refcount;
+  bool cached; /* false if evicted (or never inserted) whilst in use */
+  char data[];
+} CacheEntry;
+
+typedef struct {
+  CacheEntry *entry;
+  long int len;
+} ReaderCacheMemData;
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static _Optional CacheEntry *mru, *lru;
+static size_t budget, used;
+static GKeyCacheStats stats;
+
+static bool same_key(CacheKey const *const a, CacheKey const *const b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+  return a->dev == b->dev && a->ino == b->ino && a->mtime == b->mtime &&
+         a->mtime_nsec == b->mtime_nsec && a->size == b->size &&
+         a->offset == b->offset && a->history_log_2 == b->history_log_2;
+}
+
+static void unlink_entry(CacheEntry *const entry)
+{
+  assert(entry != NULL);
+  assert(entry->cached);
+
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    mru = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    lru = entry->prev;
+  }
+  entry->cached = false;
+  used -= entry->len;
+}
+
+static void push_mru(CacheEntry *const entry)
+{
+  assert(entry != NULL);
+  assert(!entry->cached);
+
+  entry->prev = NULL;
+  entry->next = mru;
+  if (mru) {
+    mru->prev = entry;
+  } else {
+    lru = entry;
+  }
+  mru = entry;
+  entry->cached = true;
+  used += entry->len;
+}
+
+static void trim(size_t const limit)
+{
+  /* Entries in use can't be freed, but are freed when released if they
+     no longer belong to the cache. */
+  for (_Optional CacheEntry *entry = lru; entry && used > limit;) {
+    _Optional CacheEntry *const prev = entry->prev;
+    if (entry->refcount == 0) {
+      DEBUGF("Evicting %zu bytes from the cache\n", entry->len);
+      unlink_entry(&*entry);
+      stats.evictions++;
+      free(entry);
+    }
+    entry = prev;
+  }
+}
+
+static void release(CacheEntry *const entry)
+{
+  assert(entry != NULL);
+
+  pthread_mutex_lock(&mutex);
+  assert(entry->refcount > 0);
+  bool const dead = --entry->refcount == 0 && !entry->cached;
+  trim(budget);
+  pthread_mutex_unlock(&mutex);
+
+  if (dead) {
+    free(entry);
+  }
+}
+
+static _Optional CacheEntry *lookup(CacheKey const *const key)
+{
+  assert(key != NULL);
+  _Optional CacheEntry *found = NULL;
+
+  pthread_mutex_lock(&mutex);
+  for (_Optional CacheEntry *entry = mru; entry; entry = entry->next) {
+    if (same_key(&entry->key, key)) {
+      unlink_entry(&*entry);
+      push_mru(&*entry);
+      entry->refcount++;
+      found = entry;
+      break;
+    }
+  }
+  if (found) {
+    stats.hits++;
+  } else {
+    stats.misses++;
+  }
+  pthread_mutex_unlock(&mutex);
+
+  return found;
+}
+
+static CacheEntry *insert(CacheEntry *const entry)
+{
+  assert(entry != NULL);
+  assert(entry->refcount == 1);
+  assert(!entry->cached);
+  CacheEntry *result = entry;
+
+  pthread_mutex_lock(&mutex);
+
+  /* Another thread may have decompressed the same file meanwhile */
+  for (_Optional CacheEntry *e = mru; e; e = e->next) {
+    if (same_key(&e->key, &entry->key)) {
+      e->refcount++;
+      result = &*e;
+      break;
+    }
+  }
+
+  if (result == entry) {
+    trim(budget > entry->len ? budget - entry->len : 0);
+    if (used + entry->len <= budget) {
+      push_mru(entry);
+    } else {
+      DEBUGF("No room to cache %zu bytes\n", entry->len);
+    }
+  }
+
+  pthread_mutex_unlock(&mutex);
+
+  if (result != entry) {
+    free(entry);
+  }
+  return result;
+}
+
+static bool read_rest(CacheEntry **const entry, size_t *const capacity,
+                      size_t const limit, Reader *const r)
+{
+  assert(entry != NULL);
+  assert(*entry != NULL);
+  assert(capacity != NULL);
+  assert(r != NULL);
+
+  /* The size of a multi-member stream is only known once every member has
+     been decompressed, so grow the entry until the end of the stream. */
+  size_t len = (*entry)->len;
+  for (;;) {
+    if (len == *capacity) {
+      int const c = reader_fgetc(r);
+      if (c == EOF) {
+        break;
+      }
+
+      if (*capacity >= limit) {
+        DEBUGF("Too big to cache more than %zu bytes\n", limit);
+        return false;
+      }
+
+      size_t new_capacity = *capacity < MinCapacity ? MinCapacity :
+                                                      *capacity * 2;
+      if (new_capacity > limit || new_capacity < *capacity) {
+        new_capacity = limit;
+      }
+
+      if (new_capacity > SIZE_MAX - sizeof(CacheEntry)) {
+        DEBUGF("Too big to cache %zu bytes\n", new_capacity);
+        return false;
+      }
+
+      _Optional CacheEntry *const bigger =
+          realloc(*entry, sizeof(**entry) + new_capacity);
+      if (bigger == NULL) {
+        DEBUGF("Failed to extend a cache entry\n");
+        return false;
+      }
+      *entry = &*bigger;
+      *capacity = new_capacity;
+      (*entry)->data[len++] = (char)c;
+    }
+
+    len += reader_fread((*entry)->data + len, 1, *capacity - len, r);
+    if (len < *capacity) {
+      break;
+    }
+  }
+
+  if (reader_ferror(r)) {
+    return false;
+  }
+
+  (*entry)->len = len;
+  if (len < *capacity) {
+    /* Give back any unused space. Failure is harmless. */
+    _Optional CacheEntry *const smaller =
+        realloc(*entry, sizeof(**entry) + len);
+    if (smaller != NULL) {
+      *entry = &*smaller;
+      *capacity = len;
+    }
+  }
+  return true;
+}
+
+static _Optional CacheEntry *decompress(CacheKey const *const key,
+                                        size_t const limit, FILE *const in)
+{
+  assert(key != NULL);
+  assert(in != NULL);
+
+  /* Read the decompressed size from the header, which may be shorter than
+     the longest header form */
+  unsigned char hdr[GKeyHdr_MemberSize];
+  size_t const hdr_len = fread(hdr, 1, sizeof(hdr), in);
+  GKeyHdrInfo info;
+  bool const got_hdr = gkey_hdr_parse(hdr, hdr_len, &info);
+  if (fseek(in, key->offset, SEEK_SET) || !got_hdr) {
+    DEBUGF("Can't get decompressed size\n");
+    return NULL;
+  }
+
+  if (info.out_len > limit || info.out_len > SIZE_MAX - sizeof(CacheEntry)) {
+    DEBUGF("Too big to cache %" PRIu64 " bytes\n", info.out_len);
+    return NULL;
+  }
+
+  /* For a multi-member stream, this is the size of the first member only */
+  size_t capacity = (size_t)info.out_len;
+  _Optional CacheEntry *entry = malloc(sizeof(*entry) + capacity);
+  if (entry == NULL) {
+    DEBUGF("Failed to allocate a cache entry\n");
+    return NULL;
+  }
+
+  *entry = (CacheEntry){
+    .prev = NULL,
+    .next = NULL,
+    .key = *key,
+    .len = capacity,
+    .refcount = 1,
+    .cached = false,
+  };
+
+  Reader r;
+  bool ok = reader_gkey_init(&r, key->history_log_2, in);
+  if (ok) {
+    ok = reader_fread(entry->data, 1, capacity, &r) == capacity;
+    if (ok && info.member) {
+      CacheEntry *grown = &*entry;
+      ok = read_rest(&grown, &capacity, limit, &r);
+      entry = grown;
+    }
+    reader_destroy(&r);
+  }
+
+  if (!ok) {
+    /* Let the caller fall back to an uncached reader, which will report
+       any error in the usual way */
+    DEBUGF("Failed to decompress into the cache\n");
+    free(entry);
+    return NULL;
+  }
+
+  return insert(&*entry);
+}
+
+static size_t reader_cache_mem_fread(void *const ptr, size_t const size,
+                                     Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderCacheMemData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  if (reader->fpos > data->len) {
+    DEBUGF("Can't seek beyond end at %ld\n", data->len);
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t n = size;
+  if ((unsigned long)(data->len - reader->fpos) < n) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+    n = (size_t)(data->len - reader->fpos);
+  }
+
+  memcpy(ptr, data->entry->data + reader->fpos, n);
+  return n;
+}
+
+static _Optional const void *reader_cache_mem_peek(size_t *const size,
+                                                   Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderCacheMemData *const data = reader->data;
+  assert(data != NULL);
+
+  if (reader->fpos >= data->len) {
+    return NULL;
+  }
+  *size = (size_t)(data->len - reader->fpos);
+  return data->entry->data + reader->fpos;
+}
+
+static void reader_cache_mem_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderCacheMemData *const data = reader->data;
+  assert(data != NULL);
+
+  release(data->entry);
+  free(data);
+}
+
+static bool get_key(CacheKey *const key, unsigned int const history_log_2,
+                    FILE *const in)
+{
+  assert(key != NULL);
+  assert(in != NULL);
+
+  struct stat st;
+  long int const offset = ftell(in);
+  if (offset < 0 || fstat(fileno(in), &st) || !S_ISREG(st.st_mode)) {
+    DEBUGF("Can't identify file\n");
+    return false;
+  }
+
+  *key = (CacheKey){
+    .dev = st.st_dev,
+    .ino = st.st_ino,
+    .mtime = st.st_mtime,
+    .mtime_nsec = MTIME_NSEC(st),
+    .size = st.st_size,
+    .offset = offset,
+    .history_log_2 = history_log_2,
+  };
+  return true;
+}
+
+static bool init_from_cache(Reader *const reader,
+                            unsigned int const history_log_2, FILE *const in)
+{
+  assert(reader != NULL);
+  assert(in != NULL);
+
+  pthread_mutex_lock(&mutex);
+  size_t const limit = budget;
+  pthread_mutex_unlock(&mutex);
+
+  CacheKey key;
+  if (limit == 0 || !get_key(&key, history_log_2, in)) {
+    return false;
+  }
+
+  _Optional ReaderCacheMemData *const data = malloc(sizeof(*data));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  _Optional CacheEntry *entry = lookup(&key);
+  if (entry == NULL) {
+    entry = decompress(&key, limit, in);
+    if (entry == NULL) {
+      free(data);
+      return false;
+    }
+  }
+
+  assert((unsigned long)entry->len <= LONG_MAX);
+  *data = (ReaderCacheMemData){.entry = &*entry, .len = (long)entry->len};
+
+  static ReaderFns const fns = {reader_cache_mem_fread,
+                                reader_cache_mem_destroy,
+                                reader_cache_mem_peek};
+  reader_internal_init(reader, &fns, &*data);
+  return true;
+}
+
+#endif /* FILE_CACHE */
+
+void gkey_cache_set_budget(size_t const new_budget)
+{
+#ifdef FILE_CACHE
+  pthread_mutex_lock(&mutex);
+  DEBUGF("Cache budget is %zu bytes\n", new_budget);
+  budget = new_budget;
+  trim(budget);
+  pthread_mutex_unlock(&mutex);
+#else
+  NOT_USED(new_budget);
+#endif
+}
+
+void gkey_cache_stats(GKeyCacheStats *const out)
+{
+  assert(out != NULL);
+#ifdef FILE_CACHE
+  pthread_mutex_lock(&mutex);
+  *out = stats;
+  out->used = used;
+  pthread_mutex_unlock(&mutex);
+#else
+  *out = (GKeyCacheStats){.hits = 0, .misses = 0, .evictions = 0,
+                          .used = 0};
+#endif
+}
+
+bool reader_gkey_init_cached(Reader *const reader,
+                             unsigned int const history_log_2,
+                             FILE *const in)
+{
+  assert(reader != NULL);
+  assert(in != NULL);
+
+#ifdef FILE_CACHE
+  long int const offset = ftell(in);
+  if (init_from_cache(reader, history_log_2, in)) {
+    return true;
+  }
+
+  /* Decompress the file directly instead */
+  if (offset >= 0 && fseek(in, offset, SEEK_SET)) {
+    return false;
+  }
+#endif
+  return reader_gkey_init(reader, history_log_2, in);
+}
@@ -0,0 +1,79 @@
+/*
+ * StreamLib: Process-wide cache of decompressed files
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef GKeyCache_h
+#define GKeyCache_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Local header files */
+#include "Reader.h"
+
+typedef struct {
+  unsigned long hits;      /* files found in the cache */
+  unsigned long misses;    /* files not found in the cache */
+  unsigned long evictions; /* files discarded to make room */
+  size_t used;             /* size of the cached data, in bytes */
+} GKeyCacheStats;
+
+void gkey_cache_set_budget(size_t /*budget*/);
+/*
+ * sets the maximum total size (in bytes) of the decompressed data kept in
+ * a cache shared by all readers created by reader_gkey_init_cached, and
+ * discards the least recently used data that is no longer in use until
+ * the cache fits. The cache is disabled if 'budget' is 0 (the default).
+ * Only supported on POSIX systems; otherwise this function does nothing.
+ */
+
+void gkey_cache_stats(GKeyCacheStats * /*stats*/);
+/*
+ * gets the number of cache hits, misses and evictions so far, and the
+ * current size of the cached data, and stores them in the object pointed
+ * to by 'stats'.
+ */
+
+bool reader_gkey_init_cached(Reader * /*reader*/,
+                             unsigned int /*history_log_2*/, FILE * /*in*/);
+/*
+ * creates an abstract reader object to allow data in Gordon Key's
+ * compressed format to be read from a file pointed to by 'in', like
+ * reader_gkey_init, but using a process-wide cache of decompressed data.
+ * Files are identified by their device, inode, modification time and
+ * size, the current file position and 'history_log_2'. If the file is
+ * in the cache then data is read from memory without decompressing it.
+ * Otherwise, if it fits in the cache, the whole file is decompressed
+ * and added to the cache. Data in the cache is shared (and not freed)
+ * until all readers using it have been destroyed. If the file can't
+ * be cached then this function is equivalent to reader_gkey_init.
+ * The returned reader can't be used with reader_gkey_reinit.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* GKeyCache_h */
@@ -0,0 +1,118 @@
+/*
+ * StreamLib: Gordon Key compressed stream header layout
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added gkey_hdr_parse.
+*/
+
+#ifndef GKeyHdr_h
+#define GKeyHdr_h
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* A classic header is the decompressed size as a 32-bit little-endian
+   signed integer. An extended header instead begins with a negative
+   marker, followed by a 32-bit version and flags word and the size as a
+   64-bit little-endian integer (low word first). A member header is an
+   extended header with the member flag set, followed by the size of the
+   compressed data (excluding the header) as another 64-bit integer.
+   Members can be concatenated to form one logical stream. */
+enum {
+  GKeyHdr_ClassicSize = 4,
+  GKeyHdr_ExtendedSize = 16,
+  GKeyHdr_MemberSize = 24,
+  GKeyHdr_Marker = -1,
+  GKeyHdr_VersionMask = 0xff,
+  GKeyHdr_Version = 1,
+  GKeyHdr_Member = 0x100,
+};
+
+typedef struct {
+  size_t hdr_size;  /* number of bytes in the header */
+  uint64_t out_len; /* decompressed size (of this member only) */
+  bool member;      /* true if the header is a member header */
+  uint64_t in_len;  /* compressed size of a member, excluding its header */
+} GKeyHdrInfo;
+
+static inline uint32_t gkey_hdr_get32(unsigned char const *const in)
+{
+  uint32_t val = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    val |= (uint32_t)in[i] << (CHAR_BIT * i);
+  }
+  return val;
+}
+
+static inline uint64_t gkey_hdr_get64(unsigned char const *const in)
+{
+  return ((uint64_t)gkey_hdr_get32(in + 4) << 32) | gkey_hdr_get32(in);
+}
+
+/* Decodes any of the three header forms from the first 'in_size' bytes at
+   'in'. Fails if the header is truncated or malformed. */
+static inline bool gkey_hdr_parse(unsigned char const *const in,
+                                  size_t const in_size,
+                                  GKeyHdrInfo *const info)
+{
+  if (in_size < GKeyHdr_ClassicSize) {
+    return false;
+  }
+
+  uint32_t const len = gkey_hdr_get32(in);
+  if (len != (uint32_t)GKeyHdr_Marker) {
+    if (len > INT32_MAX) {
+      return false;
+    }
+    *info = (GKeyHdrInfo){.hdr_size = GKeyHdr_ClassicSize, .out_len = len,
+                          .member = false, .in_len = 0};
+    return true;
+  }
+
+  if (in_size < GKeyHdr_ExtendedSize) {
+    return false;
+  }
+
+  /* The only flag defined so far is the member flag */
+  uint32_t const version = gkey_hdr_get32(in + 4);
+  if ((version & GKeyHdr_VersionMask) != GKeyHdr_Version ||
+      (version & ~(uint32_t)(GKeyHdr_VersionMask | GKeyHdr_Member)) != 0) {
+    return false;
+  }
+
+  *info = (GKeyHdrInfo){.hdr_size = GKeyHdr_ExtendedSize,
+                        .out_len = gkey_hdr_get64(in + 8),
+                        .member = (version & GKeyHdr_Member) != 0,
+                        .in_len = 0};
+  if (info->member) {
+    if (in_size < GKeyHdr_MemberSize) {
+      return false;
+    }
+    info->hdr_size = GKeyHdr_MemberSize;
+    info->in_len = gkey_hdr_get64(in + 16);
+  }
+  return true;
+}
+
+#endif /* GKeyHdr_h */
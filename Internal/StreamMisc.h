@@ -24,6 +24,9 @@ History:
   CJB: 07-Jun-20: Added support for verbose debugging output.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
   CJB: 15-Jun-26: Send the debug log to stderr not stdout.
+  CJB: 18-Oct-26: Route malloc, realloc and free through the allocator
+                  hooks installed by stream_set_allocator.
+                  Added reader_raw_file and writer_raw_file.
 */
 
 #ifndef StreamMisc_h
@@ -58,37 +61,53 @@ History:
 
 #endif /* USE_CBDEBUG */
 
-#ifdef USE_OPTIONAL
 #include <stdlib.h>
 
+#ifdef USE_OPTIONAL
 #undef NULL
 #define NULL ((_Optional void *)0)
+#else
+#define _Optional
+#endif
 
-static inline void optional_free(_Optional void *x)
+/* Direct access to the standard C library's allocator (or Fortify's, if
+   enabled), regardless of any hooks installed by the client. */
+static inline void stream_std_free(_Optional void *x)
 {
     free((void *)x);
 }
-#undef free
-#define free(x) optional_free(x)
 
-static inline _Optional void *optional_malloc(size_t n)
+static inline _Optional void *stream_std_malloc(size_t n)
 {
     return malloc(n);
 }
-#undef malloc
 
-#define malloc(n) optional_malloc(n)
-
-static inline _Optional void *optional_realloc(_Optional void *p, size_t n)
+static inline _Optional void *stream_std_realloc(_Optional void *p, size_t n)
 {
     return realloc((void *)p, n);
 }
-#undef realloc
-#define realloc(p, n) optional_realloc(p, n)
 
-#else
-#define _Optional
-#endif
+struct StreamAllocator const *stream_std_allocator(void);
+
+/* All other allocations made by this library go through the hooks
+   installed by stream_set_allocator. */
+_Optional void *stream_malloc(size_t n);
+_Optional void *stream_realloc(_Optional void *p, size_t n);
+void stream_free(_Optional void *p);
+
+#undef free
+#define free(x) stream_free(x)
+#undef malloc
+#define malloc(n) stream_malloc(n)
+#undef realloc
+#define realloc(p, n) stream_realloc(p, n)
+
+/* Get the file underlying a reader or writer object created by
+   reader_raw_init or writer_raw_init, or null for any other type. */
+struct Reader;
+struct Writer;
+_Optional FILE *reader_raw_file(struct Reader const *reader);
+_Optional FILE *writer_raw_file(struct Writer const *writer);
 
 #define NOT_USED(x) ((void)(x))
 
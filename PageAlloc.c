@@ -0,0 +1,286 @@
+/*
+ * StreamLib: Page-mapping memory allocator
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Blocks smaller than MapThreshold are plain malloc blocks
+                  and mapped blocks are recorded in a table instead of
+                  being prefixed with a header.
+*/
+
+#if defined(__linux__) && defined(STREAM_THREADS)
+/* Required for mremap and MAP_ANONYMOUS */
+#define _GNU_SOURCE
+#endif
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(STREAM_THREADS)
+/* Linux header files */
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define PAGE_MAP
+#endif
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "PageAlloc.h"
+
+enum {
+  MapThreshold = 128 * 1024, /* Minimum size of a mapped block */
+  HugePageSize = 2 * 1024 * 1024,
+};
+
+typedef struct {
+  bool huge_pages;
+} PageAllocParams;
+
+#ifdef PAGE_MAP
+/* Mapped blocks are recorded here rather than in a header, so that
+   every other block is exactly as returned by malloc. There are few
+   mapped blocks because each is at least MapThreshold bytes. */
+typedef struct MapEntry {
+  _Optional struct MapEntry *next;
+  void *base;
+  size_t len; /* size of the mapping */
+} MapEntry;
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static _Optional MapEntry *maps;
+
+static _Optional MapEntry *find_map(_Optional void const *const ptr)
+{
+  _Optional MapEntry *entry = NULL;
+
+  if (ptr) {
+    pthread_mutex_lock(&mutex);
+    entry = maps;
+    while (entry && entry->base != ptr) {
+      entry = entry->next;
+    }
+    pthread_mutex_unlock(&mutex);
+  }
+  return entry;
+}
+
+static void add_map(MapEntry *const entry)
+{
+  assert(entry != NULL);
+  pthread_mutex_lock(&mutex);
+  entry->next = maps;
+  maps = entry;
+  pthread_mutex_unlock(&mutex);
+}
+
+static void remove_map(MapEntry *const entry)
+{
+  assert(entry != NULL);
+  pthread_mutex_lock(&mutex);
+  _Optional MapEntry **prev = &maps;
+  while (*prev != entry) {
+    assert(*prev != NULL);
+    prev = &(*prev)->next;
+  }
+  *prev = entry->next;
+  pthread_mutex_unlock(&mutex);
+  stream_std_free(entry);
+}
+
+static size_t map_length(size_t const size, bool const huge_pages)
+{
+  long const page_size = sysconf(_SC_PAGESIZE);
+  size_t const unit = huge_pages ? (size_t)HugePageSize :
+                      page_size > 0 ? (size_t)page_size : 4096u;
+
+  if (size > SIZE_MAX - (unit - 1)) {
+    return 0;
+  }
+  return ((size + unit - 1) / unit) * unit;
+}
+
+static void advise(void *const base, size_t const len, bool const huge_pages)
+{
+#ifdef MADV_HUGEPAGE
+  if (huge_pages && madvise(base, len, MADV_HUGEPAGE)) {
+    /* Merely advisory, so ignore failure (e.g. if THP is disabled) */
+    DEBUGF("madvise failed for %zu bytes at %p\n", len, base);
+  }
+#else
+  NOT_USED(base);
+  NOT_USED(len);
+  NOT_USED(huge_pages);
+#endif
+}
+
+static _Optional void *remap_block(MapEntry *const entry, size_t const size,
+                                   bool const huge_pages)
+{
+  assert(entry != NULL);
+
+  size_t const len = map_length(size, huge_pages);
+  if (len == 0) {
+    DEBUGF("Block size %zu is too big to map\n", size);
+    return NULL;
+  }
+
+  if (len != entry->len) {
+    /* Move or resize the existing pages instead of copying their data. */
+    DEBUGF("Remapping %zu bytes to %zu\n", entry->len, len);
+    void *const base = mremap(entry->base, entry->len, len, MREMAP_MAYMOVE);
+    if (base == MAP_FAILED) {
+      DEBUGF("mremap failed\n");
+      return NULL;
+    }
+
+    pthread_mutex_lock(&mutex);
+    entry->base = base;
+    entry->len = len;
+    pthread_mutex_unlock(&mutex);
+    advise(base, len, huge_pages);
+  }
+  return entry->base;
+}
+
+static _Optional void *map_block(_Optional void *const old,
+                                 size_t const size, bool const huge_pages)
+{
+  size_t const len = map_length(size, huge_pages);
+  if (len == 0) {
+    DEBUGF("Block size %zu is too big to map\n", size);
+    return NULL;
+  }
+
+  _Optional MapEntry *const entry = stream_std_malloc(sizeof(*entry));
+  if (entry == NULL) {
+    DEBUGF("Failed to allocate a mapping record\n");
+    return NULL;
+  }
+
+  DEBUGF("Mapping %zu bytes\n", len);
+  void *const base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    DEBUGF("mmap failed\n");
+    stream_std_free(entry);
+    return NULL;
+  }
+
+  advise(base, len, huge_pages);
+
+  if (old) {
+    /* The data must be copied once, when a small block becomes big. The
+       block was allocated by malloc, which doesn't record the size
+       requested, but its usable size is never less. */
+    size_t const old_size = malloc_usable_size((void *)old);
+    memcpy(base, (void *)old, old_size < size ? old_size : size);
+    stream_std_free(old);
+  }
+
+  *entry = (MapEntry){.next = NULL, .base = base, .len = len};
+  add_map(&*entry);
+  return base;
+}
+
+static _Optional void *unmap_block(MapEntry *const entry, size_t const size)
+{
+  /* A block that shrinks below the threshold becomes a malloc block
+     again, so that it can be freed by calling free. */
+  assert(entry != NULL);
+  assert(size < entry->len);
+
+  _Optional void *const ptr = stream_std_malloc(size);
+  if (ptr == NULL) {
+    DEBUGF("Failed to allocate %zu bytes\n", size);
+    return NULL;
+  }
+
+  memcpy((void *)ptr, entry->base, size);
+  DEBUGF("Unmapping %zu bytes\n", entry->len);
+  if (munmap(entry->base, entry->len)) {
+    DEBUGF("munmap failed\n");
+  }
+  remove_map(entry);
+  return ptr;
+}
+#endif /* PAGE_MAP */
+
+static _Optional void *page_realloc(_Optional void *const ptr,
+                                    size_t const size, void *const ctx)
+{
+  PageAllocParams const *const params = ctx;
+  assert(params != NULL);
+
+#ifdef PAGE_MAP
+  _Optional MapEntry *const entry = find_map(ptr);
+  if (entry) {
+    return size >= MapThreshold ?
+           remap_block(&*entry, size, params->huge_pages) :
+           unmap_block(&*entry, size);
+  }
+
+  if (size >= MapThreshold) {
+    return map_block(ptr, size, params->huge_pages);
+  }
+#else
+  NOT_USED(params);
+#endif
+
+  return stream_std_realloc(ptr, size);
+}
+
+static _Optional void *page_alloc(size_t const size, void *const ctx)
+{
+  return page_realloc(NULL, size, ctx);
+}
+
+static void page_free(_Optional void *const ptr, void *const ctx)
+{
+  NOT_USED(ctx);
+
+#ifdef PAGE_MAP
+  _Optional MapEntry *const entry = find_map(ptr);
+  if (entry) {
+    DEBUGF("Unmapping %zu bytes\n", entry->len);
+    if (munmap(entry->base, entry->len)) {
+      DEBUGF("munmap failed\n");
+    }
+    remove_map(&*entry);
+    return;
+  }
+#endif
+
+  stream_std_free(ptr);
+}
+
+StreamAllocator const *page_allocator(bool const huge_pages)
+{
+  static PageAllocParams const params[] = {{false}, {true}};
+  static StreamAllocator const allocators[] = {
+    {page_alloc, page_realloc, page_free, (void *)&params[0]},
+    {page_alloc, page_realloc, page_free, (void *)&params[1]},
+  };
+  return &allocators[huge_pages ? 1 : 0];
+}
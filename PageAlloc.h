@@ -0,0 +1,57 @@
+/*
+ * StreamLib: Page-mapping memory allocator
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library, Linux system calls and POSIX threads
+              (optional).
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Small blocks can be freed by calling free.
+*/
+
+#ifndef PageAlloc_h
+#define PageAlloc_h
+
+/* ISO library header files */
+#include <stdbool.h>
+
+/* Local header files */
+#include "Allocator.h"
+
+StreamAllocator const *page_allocator(bool /*huge_pages*/);
+/*
+ * gets an allocator which is intended for growing large buffers, e.g.
+ * by passing it to writer_heap_init_with_alloc. On Linux, blocks of
+ * 128 KiB or more are mapped directly from the kernel and are grown or
+ * shrunk by remapping their pages instead of copying their contents.
+ * If 'huge_pages' is true then such blocks are also rounded up to a
+ * multiple of 2 MiB and the kernel is advised to back them with
+ * transparent huge pages. Smaller blocks (and all blocks on other
+ * systems) are allocated by calling malloc, without any header, so they
+ * can be freed by calling free and any block allocated by malloc can be
+ * passed to this allocator's realloc_fn or free_fn. A mapped block that
+ * shrinks below 128 KiB is moved back into a block allocated by malloc.
+ * Mapped blocks must only be resized or freed by calling the allocator's
+ * realloc_fn or free_fn, because they were not allocated by malloc.
+ * Returns: the address of an allocator object with static storage
+ *          duration.
+ */
+
+#endif /* PageAlloc_h */
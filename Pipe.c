@@ -0,0 +1,323 @@
+/*
+ * StreamLib: Single-producer/single-consumer memory pipe
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added pipe_broken.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX header files */
+#include <pthread.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "Pipe.h"
+
+enum {
+  MinCapacity = 16,
+};
+
+/* The producer owns 'head' and the consumer owns 'tail'. Both are
+   free-running counters, so 'head - tail' is the number of bytes in the
+   buffer even after they wrap around. */
+struct Pipe {
+  _Optional char *buffer;
+  size_t mask;
+  size_t head, tail;
+  bool write_closed, read_closed;
+  bool producer_waiting, consumer_waiting;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+};
+
+static inline size_t load(size_t const *const counter)
+{
+  return __atomic_load_n(counter, __ATOMIC_SEQ_CST);
+}
+
+static inline void store(size_t *const counter, size_t const value)
+{
+  __atomic_store_n(counter, value, __ATOMIC_SEQ_CST);
+}
+
+static inline bool load_flag(bool const *const flag)
+{
+  return __atomic_load_n(flag, __ATOMIC_SEQ_CST);
+}
+
+static inline void store_flag(bool *const flag, bool const value)
+{
+  __atomic_store_n(flag, value, __ATOMIC_SEQ_CST);
+}
+
+static size_t capacity(Pipe const *const pipe)
+{
+  assert(pipe != NULL);
+  return pipe->mask + 1;
+}
+
+static bool can_read(Pipe const *const pipe)
+{
+  return pipe_avail(pipe) > 0 || load_flag(&pipe->write_closed);
+}
+
+static bool can_write(Pipe const *const pipe)
+{
+  return pipe_space(pipe) > 0 || load_flag(&pipe->read_closed);
+}
+
+static void wait_until(Pipe *const pipe, bool *const waiting,
+                       bool (*const ready)(Pipe const *))
+{
+  assert(pipe != NULL);
+  assert(waiting != NULL);
+  assert(ready != NULL);
+
+  pthread_mutex_lock(&pipe->mutex);
+
+  /* The other thread checks the waiting flag after updating its counter.
+     Because all of these accesses are sequentially consistent, at least
+     one of us is guaranteed to see the other's store. */
+  store_flag(waiting, true);
+
+  while (!ready(pipe)) {
+    pthread_cond_wait(&pipe->cond, &pipe->mutex);
+  }
+
+  store_flag(waiting, false);
+  pthread_mutex_unlock(&pipe->mutex);
+}
+
+static void wake(Pipe *const pipe, bool const *const waiting)
+{
+  assert(pipe != NULL);
+  assert(waiting != NULL);
+
+  if (load_flag(waiting)) {
+    /* Taking the lock guarantees that the waiter is either blocked in
+       pthread_cond_wait or hasn't yet checked its condition. */
+    pthread_mutex_lock(&pipe->mutex);
+    pthread_cond_broadcast(&pipe->cond);
+    pthread_mutex_unlock(&pipe->mutex);
+  }
+}
+
+_Optional Pipe *pipe_make(size_t const capacity)
+{
+  size_t cap = MinCapacity;
+  while (cap < capacity) {
+    if (cap > SIZE_MAX / 2) {
+      DEBUGF("Pipe capacity %zu is too big\n", capacity);
+      return NULL;
+    }
+    cap *= 2;
+  }
+
+  _Optional Pipe *const pipe = malloc(sizeof(*pipe));
+  if (pipe == NULL) {
+    DEBUGF("Failed to allocate pipe\n");
+    return NULL;
+  }
+
+  _Optional char *const buffer = malloc(cap);
+  if (buffer == NULL) {
+    DEBUGF("Failed to allocate pipe buffer of %zu bytes\n", cap);
+    free(pipe);
+    return NULL;
+  }
+
+  *pipe = (Pipe){
+    .buffer = buffer,
+    .mask = cap - 1,
+    .head = 0,
+    .tail = 0,
+    .write_closed = false,
+    .read_closed = false,
+    .producer_waiting = false,
+    .consumer_waiting = false,
+  };
+
+  if (pthread_mutex_init(&pipe->mutex, NULL)) {
+    DEBUGF("Failed to create pipe mutex\n");
+    free(buffer);
+    free(pipe);
+    return NULL;
+  }
+
+  if (pthread_cond_init(&pipe->cond, NULL)) {
+    DEBUGF("Failed to create pipe condition variable\n");
+    pthread_mutex_destroy(&pipe->mutex);
+    free(buffer);
+    free(pipe);
+    return NULL;
+  }
+
+  DEBUGF("Created pipe %p with capacity %zu\n", (void *)pipe, cap);
+  return pipe;
+}
+
+void pipe_destroy(_Optional Pipe *const pipe)
+{
+  if (pipe != NULL) {
+    pthread_cond_destroy(&pipe->cond);
+    pthread_mutex_destroy(&pipe->mutex);
+    free(pipe->buffer);
+    free(pipe);
+  }
+}
+
+size_t pipe_write(Pipe *const pipe, void const *const ptr, size_t const size,
+                  bool const blocking)
+{
+  assert(pipe != NULL);
+  assert(ptr != NULL);
+  assert(!pipe->write_closed);
+
+  char const *const src = ptr;
+  size_t done = 0;
+
+  while (done < size && !load_flag(&pipe->read_closed)) {
+    size_t const space = pipe_space(pipe);
+    if (space == 0) {
+      if (!blocking) {
+        break;
+      }
+      wait_until(pipe, &pipe->producer_waiting, can_write);
+      continue;
+    }
+
+    size_t n = size - done;
+    if (n > space) {
+      n = space;
+    }
+
+    /* Copy into the free part of the ring, which may wrap around. */
+    size_t const head = pipe->head, offset = head & pipe->mask;
+    size_t first = capacity(pipe) - offset;
+    if (first > n) {
+      first = n;
+    }
+    assert(pipe->buffer != NULL);
+    memcpy(&*pipe->buffer + offset, src + done, first);
+    memcpy(&*pipe->buffer, src + done + first, n - first);
+
+    store(&pipe->head, head + n);
+    wake(pipe, &pipe->consumer_waiting);
+    done += n;
+  }
+
+  DEBUG_VERBOSEF("Wrote %zu of %zu bytes to pipe\n", done, size);
+  return done;
+}
+
+size_t pipe_read(Pipe *const pipe, void *const ptr, size_t const size,
+                 bool const blocking)
+{
+  assert(pipe != NULL);
+  assert(ptr != NULL);
+  assert(!pipe->read_closed);
+
+  char *const dst = ptr;
+  size_t done = 0;
+
+  while (done < size) {
+    size_t const avail = pipe_avail(pipe);
+    if (avail == 0) {
+      if (!blocking || load_flag(&pipe->write_closed)) {
+        /* Data written before the producer closed the pipe must be
+           read before reporting end-of-file. */
+        if (pipe_avail(pipe) == 0) {
+          break;
+        }
+        continue;
+      }
+      wait_until(pipe, &pipe->consumer_waiting, can_read);
+      continue;
+    }
+
+    size_t n = size - done;
+    if (n > avail) {
+      n = avail;
+    }
+
+    /* Copy from the used part of the ring, which may wrap around. */
+    size_t const tail = pipe->tail, offset = tail & pipe->mask;
+    size_t first = capacity(pipe) - offset;
+    if (first > n) {
+      first = n;
+    }
+    assert(pipe->buffer != NULL);
+    memcpy(dst + done, &*pipe->buffer + offset, first);
+    memcpy(dst + done + first, &*pipe->buffer, n - first);
+
+    store(&pipe->tail, tail + n);
+    wake(pipe, &pipe->producer_waiting);
+    done += n;
+  }
+
+  DEBUG_VERBOSEF("Read %zu of %zu bytes from pipe\n", done, size);
+  return done;
+}
+
+void pipe_close_write(Pipe *const pipe)
+{
+  assert(pipe != NULL);
+  DEBUGF("Closing write end of pipe %p\n", (void *)pipe);
+  store_flag(&pipe->write_closed, true);
+  wake(pipe, &pipe->consumer_waiting);
+}
+
+void pipe_close_read(Pipe *const pipe)
+{
+  assert(pipe != NULL);
+  DEBUGF("Closing read end of pipe %p\n", (void *)pipe);
+  store_flag(&pipe->read_closed, true);
+  wake(pipe, &pipe->producer_waiting);
+}
+
+size_t pipe_avail(Pipe const *const pipe)
+{
+  assert(pipe != NULL);
+  return load(&pipe->head) - load(&pipe->tail);
+}
+
+size_t pipe_space(Pipe const *const pipe)
+{
+  assert(pipe != NULL);
+  return capacity(pipe) - pipe_avail(pipe);
+}
+
+bool pipe_broken(Pipe const *const pipe)
+{
+  assert(pipe != NULL);
+  return load_flag(&pipe->read_closed);
+}
+
+bool pipe_eof(Pipe const *const pipe)
+{
+  assert(pipe != NULL);
+  /* Check the flag first, in case more data is written before it is set */
+  return load_flag(&pipe->write_closed) && pipe_avail(pipe) == 0;
+}
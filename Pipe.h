@@ -0,0 +1,125 @@
+/*
+ * StreamLib: Single-producer/single-consumer memory pipe
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library, POSIX threads, GCC atomic built-ins.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added pipe_broken.
+*/
+
+#ifndef Pipe_h
+#define Pipe_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+typedef struct Pipe Pipe;
+
+_Optional Pipe *pipe_make(size_t /*capacity*/);
+/*
+ * creates an empty pipe to transfer data from one producer thread to
+ * one consumer thread via a ring buffer of at least 'capacity' bytes.
+ * The producer and consumer do not take a lock unless one of them must
+ * wait for the other (because the buffer is full or empty).
+ * Returns: the address of the new object, or null if there was not
+ *          enough free memory or the synchronization objects could
+ *          not be created.
+ */
+
+void pipe_destroy(_Optional Pipe * /*pipe*/);
+/*
+ * destroys a pipe, freeing its buffer. Must not be called until both
+ * the producer and consumer have finished using it.
+ */
+
+size_t pipe_write(Pipe * /*pipe*/, void const * /*ptr*/, size_t /*size*/,
+                  bool /*blocking*/);
+/*
+ * copies up to 'size' bytes from the array pointed to by 'ptr' into a
+ * pipe. Must only be called by the producer. If 'blocking' is true then
+ * this function waits for the consumer to make space, otherwise it
+ * returns as soon as the buffer is full. It never waits after the
+ * consumer has closed the pipe.
+ * Returns: the number of bytes copied, which is fewer than specified if
+ *          the buffer became full (in non-blocking mode) or the
+ *          consumer closed the pipe.
+ */
+
+size_t pipe_read(Pipe * /*pipe*/, void * /*ptr*/, size_t /*size*/,
+                 bool /*blocking*/);
+/*
+ * copies up to 'size' bytes from a pipe to the array pointed to by 'ptr'.
+ * Must only be called by the consumer. If 'blocking' is true then this
+ * function waits for the producer to supply data, otherwise it returns
+ * as soon as the buffer is empty. It never waits after the producer has
+ * closed the pipe.
+ * Returns: the number of bytes copied, which is fewer than specified if
+ *          the buffer became empty (in non-blocking mode) or the
+ *          producer closed the pipe.
+ */
+
+void pipe_close_write(Pipe * /*pipe*/);
+/*
+ * closes the producer's end of a pipe, waking the consumer if it is
+ * waiting. Once the consumer has read all of the data already written,
+ * the pipe is at end-of-file.
+ */
+
+void pipe_close_read(Pipe * /*pipe*/);
+/*
+ * closes the consumer's end of a pipe, waking the producer if it is
+ * waiting. Any data written afterwards is discarded.
+ */
+
+size_t pipe_avail(Pipe const * /*pipe*/);
+/*
+ * gets the number of bytes which the consumer could read from a pipe
+ * without waiting. The value may increase concurrently.
+ * Returns: the number of bytes in the buffer.
+ */
+
+size_t pipe_space(Pipe const * /*pipe*/);
+/*
+ * gets the number of bytes which the producer could write to a pipe
+ * without waiting. The value may increase concurrently.
+ * Returns: the number of free bytes in the buffer.
+ */
+
+bool pipe_eof(Pipe const * /*pipe*/);
+/*
+ * indicates whether or not the producer has closed a pipe and all of the
+ * data written to it has been read.
+ * Returns: true if no more data can be read, otherwise false.
+ */
+
+bool pipe_broken(Pipe const * /*pipe*/);
+/*
+ * indicates whether or not the consumer has closed a pipe, in which case
+ * nothing more can be written to it.
+ * Returns: true if no more data can be written, otherwise false.
+ */
+
+#endif /* Pipe_h */
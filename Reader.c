@@ -41,6 +41,7 @@
   CJB: 28-Nov-20: Initialize struct using compound literal assignment.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
   CJB: 19-May-26: Explicitly convert between size_t and long int.
+  CJB: 18-Oct-26: Allow a short count from a non-blocking reader.
 */
 
 /* ISO library header files */
@@ -127,7 +128,8 @@ size_t reader_fread(void *ptr, size_t const size, size_t const nmemb,
         nread = size == 1 ? nbytes : nbytes / size;
       }
       DEBUG_VERBOSEF("Got %zu members of size %zu\n", nread, size);
-      assert(nread == nmemb || reader->error || reader->eof);
+      /* A non-blocking reader may return less without setting either
+         indicator, if no more data is available yet. */
     }
   }
 
@@ -27,6 +27,8 @@ History:
   CJB: 10-Jul-20: Added signed 16-bit and unsigned 32-bit read functions.
   CJB: 28-Jul-22: Removed redundant use of the 'extern' keyword.
   CJB: 19-May-26: Use bool type for bitfields.
+  CJB: 18-Oct-26: Added an optional peek function for zero-copy reads.
+                  A non-blocking reader may return a short count.
 */
 
 #ifndef Reader_h
@@ -38,6 +40,10 @@ History:
 #include <stdint.h>
 #include <stdio.h>
 
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
 struct Reader;
 
 typedef size_t ReaderReadFn(void *ptr, size_t size, struct Reader *reader);
@@ -58,9 +64,23 @@ typedef void ReaderTermFn(struct Reader *reader);
  * already set.
  */
 
+typedef _Optional const void *ReaderPeekFn(size_t *size,
+                                           struct Reader *reader);
+/*
+ * gets the address of the data at the current file position of a given
+ * abstract reader object (without advancing the file position), and
+ * stores the number of bytes that can be read contiguously from that
+ * address in the object pointed to by 'size'. The data must remain valid
+ * until the next call to a function that operates on the same reader.
+ * This function must not set the error or end-of-file indicator.
+ * Returns: the address of the data, or null if none can be accessed
+ *          without copying it.
+ */
+
 typedef struct {
   ReaderReadFn *fread_fn;
   ReaderTermFn *term_fn;
+  _Optional ReaderPeekFn *peek_fn; /* may be null */
 } ReaderFns;
 
 typedef struct Reader {
@@ -145,11 +165,27 @@ size_t reader_fread(void * /*ptr*/, size_t /*size*/, size_t /*nmemb*/,
  * specified by 'size'. The file position indicator is advanced by the
  * number of bytes successfully read. If fewer than the requested number of
  * members were read then this function sets the end-of-file or error
- * indicator as appropriate.
+ * indicator as appropriate, unless the reader is non-blocking and no more
+ * data is available yet (see reader_pipe_init).
  * Returns: the number of members successfully read, which may be fewer
  *          than specified if a read error or end-of-file occurred.
  */
 
+_Optional const void *reader_fpeek(Reader * /*reader*/, size_t * /*size*/);
+/*
+ * gets the address of data at the current file position of a given
+ * abstract reader object, if it can be accessed without copying it, and
+ * stores the number of bytes that can be read contiguously from that
+ * address in the object pointed to by 'size'. The file position indicator
+ * is not advanced; call reader_fseek with SEEK_CUR to consume the data.
+ * The data remains valid until the next call to a function that operates
+ * on the same reader. Not all types of reader support this function, and
+ * it fails if a character was pushed back or either the end-of-file or
+ * error indicator is set. Callers should then use reader_fread instead.
+ * Returns: the address of the data, or null (storing 0 as the size) if
+ *          none can be accessed without copying it.
+ */
+
 bool reader_fread_uint16(uint16_t * /*ptr*/, Reader * /*reader*/);
 /*
  * reads an unsigned 16-bit integer into the storage pointed to by 'ptr'
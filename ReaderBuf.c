@@ -0,0 +1,184 @@
+/*
+ * StreamLib: Buffered reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderBuf.h"
+
+typedef struct {
+  Reader *in;
+  long int start; /* offset of the buffered data within the input */
+  size_t len, capacity;
+  char buffer[];
+} ReaderBufData;
+
+static bool seek_in(ReaderBufData *const data, long int const pos)
+{
+  assert(data != NULL);
+
+  /* The other reader may have been used by someone else, so always seek
+     (which is cheap unless the position actually changes). */
+  if (reader_fseek(data->in, pos, SEEK_SET)) {
+    DEBUGF("Failed to seek input to %ld\n", pos);
+    return false;
+  }
+  return true;
+}
+
+static size_t refill(ReaderBufData *const data, long int const pos)
+{
+  assert(data != NULL);
+
+  data->start = pos;
+  data->len = 0;
+  if (!seek_in(data, pos)) {
+    return 0;
+  }
+
+  data->len = reader_fread(data->buffer, 1, data->capacity, data->in);
+  DEBUG_VERBOSEF("Buffered %zu bytes at %ld\n", data->len, pos);
+  return data->len;
+}
+
+static size_t buffered(ReaderBufData const *const data, long int const pos)
+{
+  assert(data != NULL);
+
+  if (pos < data->start || pos - data->start >= (long)data->len) {
+    return 0;
+  }
+  return data->len - (size_t)(pos - data->start);
+}
+
+static size_t reader_buf_fread(void *ptr, size_t const size,
+                               Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderBufData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  size_t done = 0;
+  while (done < size) {
+    long int const pos = reader->fpos + (long)done;
+    size_t const left = size - done;
+    size_t avail = buffered(data, pos);
+
+    if (avail == 0) {
+      if (left >= data->capacity) {
+        /* Too big to buffer, so read directly into the caller's buffer */
+        size_t n = 0;
+        if (seek_in(data, pos)) {
+          n = reader_fread((char *)ptr + done, 1, left, data->in);
+        }
+        done += n;
+        break;
+      }
+
+      avail = refill(data, pos);
+      if (avail == 0) {
+        break;
+      }
+    }
+
+    size_t const n = avail < left ? avail : left;
+    memcpy((char *)ptr + done, data->buffer + (pos - data->start), n);
+    done += n;
+  }
+
+  if (done != size) {
+    if (reader_ferror(data->in)) {
+      DEBUGF("set error\n");
+      reader->error = 1;
+    } else {
+      DEBUGF("set eof\n");
+      reader->eof = 1;
+    }
+  }
+
+  DEBUG_VERBOSEF("Read %zu of %zu bytes\n", done, size);
+  return done;
+}
+
+static _Optional const void *reader_buf_peek(size_t *const size,
+                                             Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderBufData *const data = reader->data;
+  assert(data != NULL);
+
+  /* Refilling the buffer doesn't affect this reader's indicators */
+  size_t const avail = buffered(data, reader->fpos);
+  *size = avail ? avail : refill(data, reader->fpos);
+  if (*size == 0) {
+    return NULL;
+  }
+  return data->buffer + (reader->fpos - data->start);
+}
+
+static void reader_buf_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  free(reader->data);
+}
+
+bool reader_buffered_init(Reader *const reader, Reader *const in,
+                          size_t const buffer_size)
+{
+  assert(reader != NULL);
+  assert(in != NULL);
+  assert(buffer_size > 0);
+
+  if (buffer_size > SIZE_MAX - sizeof(ReaderBufData)) {
+    DEBUGF("Buffer size %zu is too big\n", buffer_size);
+    return false;
+  }
+
+  _Optional ReaderBufData *const data =
+    malloc(sizeof(*data) + buffer_size);
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  data->in = in;
+  data->start = 0;
+  data->len = 0;
+  data->capacity = buffer_size;
+
+  static ReaderFns const fns = {reader_buf_fread, reader_buf_destroy,
+                                reader_buf_peek};
+  reader_internal_init(reader, &fns, &*data);
+
+  return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * StreamLib: Buffered reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderBuf_h
+#define ReaderBuf_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local header files */
+#include "Reader.h"
+
+bool reader_buffered_init(Reader * /*reader*/, Reader * /*in*/,
+                          size_t /*buffer_size*/);
+/*
+ * creates an abstract reader object to allow data to be read from the
+ * reader object pointed to by 'in' in blocks of 'buffer_size' bytes,
+ * which are stored in a buffer. Small reads (such as by reader_fgetc)
+ * and seeks within the buffered data don't use the other reader.
+ * Reads at least as big as the buffer bypass it. The data read from
+ * the other reader is assumed not to change. reader_fpeek is supported.
+ * The other reader is not destroyed with this one, and must not be
+ * destroyed until after it.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* ReaderBuf_h */
@@ -0,0 +1,351 @@
+/*
+ * StreamLib: Page-caching reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderCach.h"
+
+enum {
+  NoPage = -1,
+};
+
+typedef struct {
+  long int index;        /* page number, or NoPage if unused */
+  size_t len;            /* number of valid bytes */
+  long int prev, next;   /* neighbours in LRU order (most recent first) */
+  long int hash_next;    /* next page in the same hash bucket */
+  _Optional char *data;
+} CachePage;
+
+typedef struct {
+  Reader *in;
+  size_t page_size, npages, nbuckets;
+  long int mru, lru;
+  ReaderCacheStats stats;
+  _Optional long int *buckets;
+  CachePage pages[];
+} ReaderCacheData;
+
+static size_t hash(ReaderCacheData const *const data, long int const index)
+{
+  assert(data != NULL);
+  /* Fibonacci hashing spreads consecutive page numbers */
+  unsigned long const h = (unsigned long)index * 2654435761ul;
+  return (size_t)(h >> 8) & (data->nbuckets - 1);
+}
+
+static void unlink_lru(ReaderCacheData *const data, long int const p)
+{
+  assert(data != NULL);
+  CachePage *const page = &data->pages[p];
+
+  if (page->prev != NoPage) {
+    data->pages[page->prev].next = page->next;
+  } else {
+    data->mru = page->next;
+  }
+  if (page->next != NoPage) {
+    data->pages[page->next].prev = page->prev;
+  } else {
+    data->lru = page->prev;
+  }
+}
+
+static void push_mru(ReaderCacheData *const data, long int const p)
+{
+  assert(data != NULL);
+  CachePage *const page = &data->pages[p];
+
+  page->prev = NoPage;
+  page->next = data->mru;
+  if (data->mru != NoPage) {
+    data->pages[data->mru].prev = p;
+  } else {
+    data->lru = p;
+  }
+  data->mru = p;
+}
+
+static void unhash(ReaderCacheData *const data, long int const p)
+{
+  assert(data != NULL);
+  assert(data->buckets != NULL);
+  CachePage *const page = &data->pages[p];
+  if (page->index == NoPage) {
+    return;
+  }
+
+  long int *link = &data->buckets[hash(data, page->index)];
+  while (*link != p) {
+    assert(*link != NoPage);
+    link = &data->pages[*link].hash_next;
+  }
+  *link = page->hash_next;
+  page->index = NoPage;
+}
+
+static long int find_page(ReaderCacheData const *const data,
+                          long int const index)
+{
+  assert(data != NULL);
+  assert(data->buckets != NULL);
+
+  for (long int p = data->buckets[hash(data, index)]; p != NoPage;
+       p = data->pages[p].hash_next) {
+    if (data->pages[p].index == index) {
+      return p;
+    }
+  }
+  return NoPage;
+}
+
+static long int get_page(ReaderCacheData *const data, long int const index)
+{
+  assert(data != NULL);
+  assert(data->buckets != NULL);
+
+  long int p = find_page(data, index);
+  if (p != NoPage) {
+    data->stats.hits++;
+    unlink_lru(data, p);
+    push_mru(data, p);
+    return p;
+  }
+
+  data->stats.misses++;
+
+  /* Reuse the least recently used page. Pages are allocated on first use,
+     but if that fails then reuse the least recently used allocated page. */
+  p = data->lru;
+  CachePage *page = &data->pages[p];
+  if (page->data == NULL) {
+    page->data = malloc(data->page_size);
+    while (page->data == NULL) {
+      p = page->prev;
+      if (p == NoPage) {
+        DEBUGF("Failed to allocate a page\n");
+        return NoPage;
+      }
+      page = &data->pages[p];
+    }
+  }
+
+  if (page->index != NoPage) {
+    DEBUG_VERBOSEF("Evicting page %ld\n", page->index);
+    data->stats.evictions++;
+  }
+  unhash(data, p);
+  unlink_lru(data, p);
+  push_mru(data, p);
+
+  /* The other reader may have been used by someone else, so always seek
+     (which is cheap unless the position actually changes). */
+  assert(page->data != NULL);
+  assert((unsigned long)index <= LONG_MAX / data->page_size);
+  long int const pos = index * (long)data->page_size;
+  if (reader_fseek(data->in, pos, SEEK_SET)) {
+    return NoPage;
+  }
+
+  page->len = reader_fread(&*page->data, 1, data->page_size, data->in);
+  if (page->len != data->page_size && reader_ferror(data->in)) {
+    DEBUGF("Failed to fill page %ld\n", index);
+    return NoPage;
+  }
+
+  DEBUG_VERBOSEF("Filled page %ld with %zu bytes\n", index, page->len);
+  page->index = index;
+  size_t const b = hash(data, index);
+  page->hash_next = data->buckets[b];
+  data->buckets[b] = p;
+  return p;
+}
+
+static size_t reader_cache_fread(void *ptr, size_t const size,
+                                 Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderCacheData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  size_t done = 0;
+  while (done < size) {
+    long int const pos = reader->fpos + (long)done;
+    long int const index = pos / (long)data->page_size;
+    size_t const offset = (size_t)(pos % (long)data->page_size);
+
+    long int const p = get_page(data, index);
+    if (p == NoPage) {
+      DEBUGF("set error\n");
+      reader->error = 1;
+      return done;
+    }
+
+    CachePage const *const page = &data->pages[p];
+    if (offset >= page->len) {
+      break;
+    }
+
+    size_t n = page->len - offset;
+    if (n > size - done) {
+      n = size - done;
+    }
+    assert(page->data != NULL);
+    memcpy((char *)ptr + done, &*page->data + offset, n);
+    done += n;
+
+    if (page->len != data->page_size && done < size) {
+      break; /* last page */
+    }
+  }
+
+  if (done != size) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+  }
+  DEBUG_VERBOSEF("Read %zu of %zu bytes\n", done, size);
+  return done;
+}
+
+static _Optional const void *reader_cache_peek(size_t *const size,
+                                               Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderCacheData *const data = reader->data;
+  assert(data != NULL);
+
+  long int const index = reader->fpos / (long)data->page_size;
+  size_t const offset = (size_t)(reader->fpos % (long)data->page_size);
+
+  long int const p = get_page(data, index);
+  if (p == NoPage || offset >= data->pages[p].len) {
+    return NULL;
+  }
+
+  CachePage const *const page = &data->pages[p];
+  assert(page->data != NULL);
+  *size = page->len - offset;
+  return &*page->data + offset;
+}
+
+static void reader_cache_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderCacheData *const data = reader->data;
+  assert(data != NULL);
+
+  for (size_t i = 0; i < data->npages; ++i) {
+    free(data->pages[i].data);
+  }
+  free(data->buckets);
+  free(data);
+}
+
+bool reader_cache_init(Reader *const reader, Reader *const in,
+                       size_t const page_size, size_t const budget)
+{
+  assert(reader != NULL);
+  assert(in != NULL);
+  assert(page_size > 0);
+  assert(page_size <= LONG_MAX);
+  assert(budget >= page_size);
+
+  size_t const npages = budget / page_size;
+  size_t nbuckets = 1;
+  while (nbuckets < npages && nbuckets <= SIZE_MAX / 4) {
+    nbuckets *= 2;
+  }
+  nbuckets *= 2;
+
+  if (npages > LONG_MAX ||
+      npages > (SIZE_MAX - sizeof(ReaderCacheData)) / sizeof(CachePage) ||
+      nbuckets > SIZE_MAX / sizeof(long int)) {
+    DEBUGF("Too many pages\n");
+    return false;
+  }
+
+  _Optional ReaderCacheData *const data =
+    malloc(sizeof(*data) + npages * sizeof(data->pages[0]));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  _Optional long int *const buckets = malloc(nbuckets * sizeof(*buckets));
+  if (buckets == NULL) {
+    DEBUGF("Failed to allocate hash table\n");
+    free(data);
+    return false;
+  }
+
+  data->in = in;
+  data->page_size = page_size;
+  data->npages = npages;
+  data->nbuckets = nbuckets;
+  data->buckets = buckets;
+  data->mru = data->lru = NoPage;
+  data->stats = (ReaderCacheStats){.hits = 0, .misses = 0, .evictions = 0};
+
+  for (size_t i = 0; i < nbuckets; ++i) {
+    buckets[i] = NoPage;
+  }
+
+  for (size_t i = 0; i < npages; ++i) {
+    data->pages[i] = (CachePage){
+      .index = NoPage,
+      .len = 0,
+      .hash_next = NoPage,
+      .data = NULL,
+    };
+    push_mru(&*data, (long)i);
+  }
+
+  static ReaderFns const fns = {reader_cache_fread, reader_cache_destroy,
+                                reader_cache_peek};
+  reader_internal_init(reader, &fns, &*data);
+
+  return true;
+}
+
+void reader_cache_stats(Reader const *const reader,
+                        ReaderCacheStats *const stats)
+{
+  assert(reader != NULL);
+  assert(reader->fns.fread_fn == reader_cache_fread);
+  assert(stats != NULL);
+  ReaderCacheData const *const data = reader->data;
+  assert(data != NULL);
+
+  *stats = data->stats;
+}
@@ -0,0 +1,68 @@
+/*
+ * StreamLib: Page-caching reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderCach_h
+#define ReaderCach_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local header files */
+#include "Reader.h"
+
+typedef struct {
+  unsigned long hits;      /* reads served from a cached page */
+  unsigned long misses;    /* pages read from the other reader */
+  unsigned long evictions; /* cached pages discarded to make room */
+} ReaderCacheStats;
+
+bool reader_cache_init(Reader * /*reader*/, Reader * /*in*/,
+                       size_t /*page_size*/, size_t /*budget*/);
+/*
+ * creates an abstract reader object to allow data to be read from the
+ * reader object pointed to by 'in' in pages of 'page_size' bytes, which
+ * are kept in memory for later use. At most 'budget' bytes of pages are
+ * kept, which must be enough for at least one page: if there is no room
+ * then the least recently used page is discarded. Pages are allocated as
+ * needed. This suits random access to readers for which seeking is slow,
+ * such as compressed files. The data read from the other reader is
+ * assumed not to change. reader_fpeek is supported.
+ * The other reader is not destroyed with this one, and must not be
+ * destroyed until after it.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+void reader_cache_stats(Reader const * /*reader*/,
+                        ReaderCacheStats * /*stats*/);
+/*
+ * gets the number of cache hits, misses and evictions so far for a
+ * reader object that was created by reader_cache_init, and stores them
+ * in the object pointed to by 'stats'.
+ */
+
+#endif /* ReaderCach_h */
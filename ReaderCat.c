@@ -0,0 +1,373 @@
+/*
+ * StreamLib: Concatenation of other readers
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderCat.h"
+
+enum {
+  SkipBufferSize = 256,
+};
+
+typedef struct {
+  _Optional Reader *child; /* null if this slot is free */
+  size_t index;
+  unsigned long last_used;
+} ReaderCatSlot;
+
+typedef struct {
+  ReaderConcatOpenFn *open_fn;
+  _Optional ReaderConcatCloseFn *close_fn;
+  void *arg;
+  size_t nsources, max_open;
+  size_t nknown; /* number of leading sources with known sizes */
+  unsigned long clock;
+  _Optional long int *starts; /* start offset of each source, then the end */
+  ReaderCatSlot slots[];
+} ReaderCatData;
+
+static void close_slot(ReaderCatData *const data, ReaderCatSlot *const slot)
+{
+  assert(data != NULL);
+  assert(slot != NULL);
+
+  if (slot->child != NULL) {
+    DEBUGF("Closing source %zu\n", slot->index);
+    if (data->close_fn) {
+      data->close_fn(&*slot->child, slot->index, data->arg);
+    }
+    slot->child = NULL;
+  }
+}
+
+static _Optional Reader *get_child(ReaderCatData *const data,
+                                   size_t const index)
+{
+  assert(data != NULL);
+  assert(index < data->nsources);
+
+  /* Find the source if already open, otherwise the least recently used
+     slot (preferring a free one). */
+  ReaderCatSlot *victim = &data->slots[0];
+  for (size_t i = 0; i < data->max_open; ++i) {
+    ReaderCatSlot *const slot = &data->slots[i];
+    if (slot->child != NULL && slot->index == index) {
+      slot->last_used = ++data->clock;
+      return slot->child;
+    }
+    if (victim->child != NULL &&
+        (slot->child == NULL || slot->last_used < victim->last_used)) {
+      victim = slot;
+    }
+  }
+
+  close_slot(data, victim);
+
+  DEBUGF("Opening source %zu\n", index);
+  _Optional Reader *const child = data->open_fn(index, data->arg);
+  if (child == NULL) {
+    DEBUGF("Failed to open source %zu\n", index);
+    return NULL;
+  }
+
+  victim->child = child;
+  victim->index = index;
+  victim->last_used = ++data->clock;
+  return child;
+}
+
+static size_t find_source(ReaderCatData const *const data,
+                          long int const pos)
+{
+  assert(data != NULL);
+  assert(data->starts != NULL);
+  assert(pos >= 0);
+
+  /* Positions beyond the known sources belong to the first unknown one
+     (or are beyond the end of the input). */
+  if (pos >= data->starts[data->nknown]) {
+    return data->nknown;
+  }
+
+  /* Find the last source that starts at or before the given position.
+     Any empty sources before it start at the same offset. */
+  size_t lo = 0, hi = data->nknown - 1;
+  while (lo < hi) {
+    size_t const mid = lo + (hi - lo + 1) / 2;
+    if (data->starts[mid] <= pos) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+static void learn_size(ReaderCatData *const data, long int const size)
+{
+  assert(data != NULL);
+  assert(data->starts != NULL);
+  assert(data->nknown < data->nsources);
+  assert(size >= 0);
+
+  DEBUGF("Source %zu has size %ld\n", data->nknown, size);
+  data->starts[data->nknown + 1] = data->starts[data->nknown] + size;
+  data->nknown++;
+}
+
+static bool skip_to(ReaderCatData *const data, Reader *const child,
+                    long int const local, bool *const found)
+{
+  assert(data != NULL);
+  assert(child != NULL);
+  assert(found != NULL);
+
+  /* The size of this source is unknown, so it can't be seeked beyond
+     the data read so far without discovering where it ends. */
+  long int cur = reader_ftell(child);
+  if (local <= cur) {
+    *found = true;
+    return reader_fseek(child, local, SEEK_SET) == 0;
+  }
+
+  while (cur < local) {
+    char tmp[SkipBufferSize];
+    size_t n = sizeof(tmp);
+    if ((unsigned long)(local - cur) < n) {
+      n = (size_t)(local - cur);
+    }
+
+    size_t const nread = reader_fread(tmp, 1, n, child);
+    cur += (long)nread;
+    if (nread != n) {
+      if (reader_ferror(child)) {
+        return false;
+      }
+      learn_size(data, cur);
+      *found = false;
+      return true;
+    }
+  }
+
+  *found = true;
+  return true;
+}
+
+static size_t reader_cat_fread(void *ptr, size_t const size,
+                               Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderCatData *const data = reader->data;
+  assert(data != NULL);
+  assert(data->starts != NULL);
+  assert(reader->fpos >= 0);
+
+  size_t done = 0;
+  long int pos = reader->fpos;
+
+  while (done < size) {
+    size_t const i = find_source(data, pos);
+    if (i == data->nsources) {
+      break;
+    }
+
+    _Optional Reader *const child = get_child(data, i);
+    if (child == NULL) {
+      reader->error = 1;
+      return done;
+    }
+
+    long int const local = pos - data->starts[i];
+    size_t want = size - done;
+
+    if (i < data->nknown) {
+      if ((unsigned long)(data->starts[i + 1] - pos) < want) {
+        want = (size_t)(data->starts[i + 1] - pos);
+      }
+      if (reader_fseek(&*child, local, SEEK_SET)) {
+        reader->error = 1;
+        return done;
+      }
+    } else {
+      bool found;
+      if (!skip_to(data, &*child, local, &found)) {
+        reader->error = 1;
+        return done;
+      }
+      if (!found) {
+        continue; /* position is in a later source */
+      }
+    }
+
+    size_t const n = reader_fread((char *)ptr + done, 1, want, &*child);
+    done += n;
+    pos += (long)n;
+
+    if (n != want) {
+      if (reader_ferror(&*child) || i < data->nknown) {
+        DEBUGF("Source %zu failed or is shorter than expected\n", i);
+        reader->error = 1;
+        return done;
+      }
+      learn_size(data, local + (long)n);
+    }
+  }
+
+  if (done != size) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+  }
+  DEBUG_VERBOSEF("Read %zu of %zu bytes\n", done, size);
+  return done;
+}
+
+static _Optional const void *reader_cat_peek(size_t *const size,
+                                             Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderCatData *const data = reader->data;
+  assert(data != NULL);
+  assert(data->starts != NULL);
+
+  /* Only sources of known size can be peeked without side-effects. */
+  size_t const i = find_source(data, reader->fpos);
+  if (i >= data->nknown) {
+    return NULL;
+  }
+
+  _Optional Reader *const child = get_child(data, i);
+  if (child == NULL ||
+      reader_fseek(&*child, reader->fpos - data->starts[i], SEEK_SET)) {
+    return NULL;
+  }
+
+  _Optional const void *const ptr = reader_fpeek(&*child, size);
+  if ((unsigned long)(data->starts[i + 1] - reader->fpos) < *size) {
+    *size = (size_t)(data->starts[i + 1] - reader->fpos);
+  }
+  return ptr;
+}
+
+static void reader_cat_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderCatData *const data = reader->data;
+  assert(data != NULL);
+
+  for (size_t i = 0; i < data->max_open; ++i) {
+    close_slot(data, &data->slots[i]);
+  }
+  free(data->starts);
+  free(data);
+}
+
+bool reader_concat_init(Reader *const reader, size_t const nsources,
+                        _Optional long int const *const sizes,
+                        size_t const max_open,
+                        ReaderConcatOpenFn *const open_fn,
+                        _Optional ReaderConcatCloseFn *const close_fn,
+                        void *const arg)
+{
+  assert(reader != NULL);
+  assert(max_open > 0);
+  assert(open_fn != NULL);
+
+  if (max_open > (SIZE_MAX - sizeof(ReaderCatData)) / sizeof(ReaderCatSlot) ||
+      nsources > SIZE_MAX / sizeof(long int) - 1) {
+    DEBUGF("Too many sources\n");
+    return false;
+  }
+
+  _Optional ReaderCatData *const data =
+    malloc(sizeof(*data) + max_open * sizeof(data->slots[0]));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  _Optional long int *const starts =
+    malloc((nsources + 1) * sizeof(*starts));
+  if (starts == NULL) {
+    DEBUGF("Failed to allocate memory for source offsets\n");
+    free(data);
+    return false;
+  }
+
+  data->open_fn = open_fn;
+  data->close_fn = close_fn;
+  data->arg = arg;
+  data->nsources = nsources;
+  data->max_open = max_open;
+  data->clock = 0;
+  data->starts = starts;
+  data->nknown = 0;
+  starts[0] = 0;
+
+  for (size_t i = 0; i < max_open; ++i) {
+    data->slots[i] = (ReaderCatSlot){.child = NULL, .index = 0,
+                                     .last_used = 0};
+  }
+
+  if (sizes) {
+    for (size_t i = 0; i < nsources; ++i) {
+      assert(sizes[i] >= 0);
+      assert(sizes[i] <= LONG_MAX - starts[i]);
+      learn_size(&*data, sizes[i]);
+    }
+  }
+
+  static ReaderFns const fns = {reader_cat_fread, reader_cat_destroy,
+                                reader_cat_peek};
+  reader_internal_init(reader, &fns, &*data);
+
+  return true;
+}
+
+static _Optional Reader *open_reader(size_t const index, void *const arg)
+{
+  Reader *const *const children = arg;
+  assert(children != NULL);
+  return children[index];
+}
+
+bool reader_concat_init_readers(Reader *const reader,
+                                Reader *const *const children,
+                                size_t const nchildren)
+{
+  assert(nchildren == 0 || children != NULL);
+
+  /* The array isn't modified, although the callback argument isn't
+     const-qualified. */
+  return reader_concat_init(reader, nchildren, NULL,
+                            nchildren > 0 ? nchildren : 1, open_reader,
+                            NULL, (void *)children);
+}
@@ -0,0 +1,93 @@
+/*
+ * StreamLib: Concatenation of other readers
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderCat_h
+#define ReaderCat_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local header files */
+#include "Reader.h"
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+typedef _Optional Reader *ReaderConcatOpenFn(size_t /*index*/,
+                                             void * /*arg*/);
+/*
+ * opens the source with the given index, e.g. by opening a file and
+ * creating a reader object for it. The returned reader's file position
+ * needn't be 0 because it is repositioned as necessary.
+ * Returns: the address of a reader object, or null on failure.
+ */
+
+typedef void ReaderConcatCloseFn(Reader * /*child*/, size_t /*index*/,
+                                 void * /*arg*/);
+/*
+ * closes the source with the given index, which was previously opened
+ * by a ReaderConcatOpenFn that returned 'child', e.g. by destroying the
+ * reader object and closing the underlying file.
+ */
+
+bool reader_concat_init(Reader * /*reader*/, size_t /*nsources*/,
+                        _Optional long int const * /*sizes*/,
+                        size_t /*max_open*/,
+                        ReaderConcatOpenFn * /*open_fn*/,
+                        _Optional ReaderConcatCloseFn * /*close_fn*/,
+                        void * /*arg*/);
+/*
+ * creates an abstract reader object to allow the input from 'nsources'
+ * other readers to be read as one continuous file. Sources are opened
+ * on demand by calling 'open_fn' and closed by calling 'close_fn' (if
+ * not null); both are passed 'arg'. No more than 'max_open' sources are
+ * open at once: the least recently used is closed to make room.
+ * If 'sizes' is not null then it points to an array of the sizes of the
+ * sources (in bytes), which allows seeking directly to the right source.
+ * Otherwise, the size of each source is discovered when it is read to
+ * the end, and seeking beyond the sources already read requires reading
+ * (and discarding) their contents. Seeking backward within a source
+ * requires the source to support that. reader_fpeek is supported if the
+ * current source supports it.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+bool reader_concat_init_readers(Reader * /*reader*/,
+                                Reader *const * /*children*/,
+                                size_t /*nchildren*/);
+/*
+ * creates an abstract reader object to allow the input from an array of
+ * 'nchildren' other readers to be read as one continuous file. Otherwise,
+ * this function is similar to reader_concat_init, but the other readers
+ * are always open and must not be destroyed until after this one.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* ReaderCat_h */
@@ -0,0 +1,85 @@
+/*
+ * StreamLib: Segmented memory buffer reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderChnk.h"
+
+static size_t reader_chunks_fread(void *ptr, size_t const size,
+                                  Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  Chunks const *const chunks = reader->data;
+  assert(chunks != NULL);
+  assert(reader->fpos >= 0);
+
+  long int const len = chunks_size(chunks);
+  if (reader->fpos > len) {
+    DEBUGF("Can't seek beyond end at %ld\n", len);
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t const nread = chunks_read(chunks, reader->fpos, ptr, size);
+  if (nread != size) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+  }
+  DEBUGF("Read %zu of %zu bytes\n", nread, size);
+
+  return nread;
+}
+
+static _Optional const void *reader_chunks_peek(size_t *const size,
+                                                Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  Chunks const *const chunks = reader->data;
+  assert(chunks != NULL);
+  assert(reader->fpos >= 0);
+
+  return chunks_get(chunks, reader->fpos, size);
+}
+
+static void reader_chunks_destroy(Reader *const reader)
+{
+  NOT_USED(reader);
+}
+
+void reader_chunks_init(Reader *const reader, Chunks const *const chunks)
+{
+  assert(reader != NULL);
+  assert(chunks != NULL);
+
+  static ReaderFns const fns = {reader_chunks_fread, reader_chunks_destroy,
+                                reader_chunks_peek};
+  /* The data pointer isn't const-qualified but this reader never writes
+     through it. */
+  reader_internal_init(reader, &fns, (Chunks *)chunks);
+}
@@ -0,0 +1,42 @@
+/*
+ * StreamLib: Segmented memory buffer reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderChnk_h
+#define ReaderChnk_h
+
+/* Local header files */
+#include "Chunks.h"
+#include "Reader.h"
+
+void reader_chunks_init(Reader * /*reader*/, Chunks const * /*chunks*/);
+/*
+ * creates an abstract reader object to allow the contents of a segmented
+ * buffer to be read as if they were stored in a file. The size of the
+ * input is the size of the stored data, which may change between reads
+ * if a writer object is also using the same buffer.
+ */
+
+#endif /* ReaderChnk_h */
@@ -96,6 +96,6 @@ void reader_flex_init(Reader *const reader, flex_ptr const anchor)
   assert(reader != NULL);
   assert(anchor != NULL);
 
-  static ReaderFns const fns = {reader_flex_fread, reader_flex_destroy};
+  static ReaderFns const fns = {reader_flex_fread, reader_flex_destroy, NULL};
   reader_internal_init(reader, &fns, anchor);
 }
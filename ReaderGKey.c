@@ -28,6 +28,18 @@
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
   CJB: 29-Apr-26: Stop dereferencing a pointer of type void *.
   CJB: 21-May-26: Refactored read_core to use long int for byte counts.
+  CJB: 18-Oct-26: Added reader_gkey_reinit and reader_gkey_reinit_from.
+                  The raw backend is now embedded in the reader's data.
+                  Large reads are decompressed straight into the
+                  caller's buffer.
+                  Added an optional ring of recently decompressed data
+                  to serve short backward seeks without rewinding.
+                  The decompressor is now reset when rewinding.
+                  Added optional retention of compressed input to allow
+                  rewinding a non-seekable backend.
+                  Added reader_gkey_init_mem.
+                  Detect an extended header with a 64-bit size.
+                  Read consecutive members of a multi-member stream.
 */
 
 /* ISO library header files */
@@ -42,9 +54,12 @@
 #include "GKeyDecomp.h"
 
 /* Local headers */
+#include "Internal/GKeyHdr.h"
 #include "Internal/StreamMisc.h"
 #include "ReaderGKey.h"
+#include "ReaderMem.h"
 #include "ReaderRaw.h"
+#include "SpillBuf.h"
 
 enum {
   BUFFER_SIZE = 256, /* No. of bytes to decompress at a time */
@@ -52,15 +67,39 @@ enum {
 
 typedef struct {
   bool read_hdr, owns_backend;
+  bool members; /* whether reading a multi-member stream */
   const char *out_ptr; /* remaining data within out_buffer */
-  long int out_total, out_len;
+  long int out_total, out_len; /* out_len is the end of the member */
+  long int in_total; /* no. of compressed bytes read after the header */
+  long int hdr_pos;  /* offset of the header in the backend */
+  long int hdr_size; /* no. of bytes in the header */
+  long int in_len;   /* no. of compressed bytes in the member */
+  _Optional const char *in_mem; /* compressed data, if all in memory */
+  size_t in_mem_size;
   GKeyDecomp *decomp;
   GKeyParameters params;
   Reader *backend;
 } ReaderGKeyState;
 
+typedef struct {
+  _Optional char *buf;
+  size_t size; /* capacity of buf */
+  size_t len;  /* no. of valid bytes, ending at the decompressed total */
+  size_t head; /* index in buf at which the next byte will be stored */
+} ReaderGKeyHistory;
+
+typedef struct {
+  _Optional SpillBuf *buf;
+  long int limit; /* maximum no. of bytes to retain */
+  long int len;   /* no. of bytes retained, starting after the header */
+  bool overflow;  /* whether any input was not retained */
+} ReaderGKeyRetain;
+
 typedef struct {
   ReaderGKeyState state;
+  ReaderGKeyHistory history; /* survives reinitialization */
+  ReaderGKeyRetain retain;   /* settings survive reinitialization */
+  Reader raw; /* backend used if owns_backend */
   struct {
     char in[BUFFER_SIZE];
     char out[BUFFER_SIZE];
@@ -80,6 +119,227 @@ static void rewind_reinit(ReaderGKeyData *const data)
   data->state.out_total = 0;
   prepare_for_output(data);
   data->state.params.in_size = 0;
+  data->state.in_total = 0;
+  data->history.len = 0;
+  data->history.head = 0;
+}
+
+static long int decomp_total(ReaderGKeyData const *const data)
+{
+  assert(data != NULL);
+
+  /* Total bytes decompressed, including any not yet output */
+  ptrdiff_t const unread =
+    (const char *)data->state.params.out_buffer - data->state.out_ptr;
+  assert(unread >= 0);
+  return data->state.out_total + (long)unread;
+}
+
+static void history_append(ReaderGKeyHistory *const history,
+                           const char *src, size_t n)
+{
+  assert(history != NULL);
+  assert(src != NULL);
+
+  if (history->buf == NULL || n == 0) {
+    return;
+  }
+
+  if (n >= history->size) {
+    /* Only the most recent bytes fit */
+    memcpy(&*history->buf, src + (n - history->size), history->size);
+    history->head = 0;
+    history->len = history->size;
+    return;
+  }
+
+  size_t const first = history->size - history->head;
+  if (n > first) {
+    memcpy(&*history->buf + history->head, src, first);
+    memcpy(&*history->buf, src + first, n - first);
+  } else {
+    memcpy(&*history->buf + history->head, src, n);
+  }
+  history->head = (history->head + n) % history->size;
+  history->len = history->len + n > history->size ?
+                 history->size : history->len + n;
+}
+
+static size_t history_read(ReaderGKeyData const *const data,
+                           long int const pos, char *const dest,
+                           size_t const n)
+{
+  assert(data != NULL);
+  assert(pos >= 0);
+  assert(dest != NULL);
+
+  ReaderGKeyHistory const *const history = &data->history;
+  long int const end = decomp_total(data);
+  assert((unsigned long)history->len <= (unsigned long)end);
+  long int const start = end - (long)history->len;
+
+  if (history->buf == NULL || pos < start || pos >= end) {
+    return 0;
+  }
+
+  size_t const copy_size = (unsigned long)(end - pos) < n ?
+                           (size_t)(end - pos) : n;
+
+  /* Index of the byte at 'pos', counting from the oldest byte */
+  size_t const index = (history->head + history->size - history->len +
+                        (size_t)(pos - start)) % history->size;
+
+  size_t const first = history->size - index;
+  if (copy_size > first) {
+    memcpy(dest, &*history->buf + index, first);
+    memcpy(dest + first, &*history->buf, copy_size - first);
+  } else {
+    memcpy(dest, &*history->buf + index, copy_size);
+  }
+
+  DEBUGF("Read %zu bytes at %ld from history\n", copy_size, pos);
+  return copy_size;
+}
+
+static bool retaining(ReaderGKeyData const *const data)
+{
+  assert(data != NULL);
+  /* Retained input is only ever that of a single-member stream */
+  return data->retain.buf != NULL && !data->retain.overflow &&
+         !data->state.members;
+}
+
+static bool can_reread(ReaderGKeyData const *const data)
+{
+  assert(data != NULL);
+  return data->state.in_mem != NULL || retaining(data);
+}
+
+static size_t in_start(ReaderGKeyData const *const data)
+{
+  assert(data != NULL);
+  assert(data->state.hdr_pos >= 0);
+  assert(data->state.hdr_size >= 0);
+  return (size_t)data->state.hdr_pos + (size_t)data->state.hdr_size;
+}
+
+static long int in_limit(ReaderGKeyData const *const data, long int const n)
+{
+  assert(data != NULL);
+  assert(n >= 0);
+
+  /* Never read beyond the compressed data of a member */
+  if (data->state.members) {
+    long int const left = data->state.in_len - data->state.in_total;
+    assert(left >= 0);
+    return left < n ? left : n;
+  }
+  return n;
+}
+
+static bool input_pending(ReaderGKeyData const *const data)
+{
+  assert(data != NULL);
+
+  if (data->state.params.in_size > 0) {
+    return true;
+  }
+
+  if (in_limit(data, 1) == 0) {
+    return false;
+  }
+
+  if (data->state.in_mem != NULL) {
+    return (unsigned long)data->state.in_total <
+             data->state.in_mem_size - in_start(data);
+  }
+
+  /* Retained input may remain after the backend reached its end */
+  if (retaining(data) && data->state.in_total < data->retain.len) {
+    return true;
+  }
+  return !reader_feof(data->state.backend) &&
+         !reader_ferror(data->state.backend);
+}
+
+static void retain_input(ReaderGKeyData *const data, size_t const n)
+{
+  assert(data != NULL);
+  ReaderGKeyRetain *const retain = &data->retain;
+
+  if (!retaining(data) || n == 0) {
+    return;
+  }
+
+  assert(retain->buf != NULL);
+  assert(retain->len == data->state.in_total);
+
+  if ((unsigned long)(retain->limit - retain->len) < n ||
+      spillbuf_write(&*retain->buf, retain->len, data->buffer.in, n) != n) {
+    /* Rewinding will require the backend to be seekable */
+    DEBUGF("Stopped retaining compressed input at %ld\n", retain->len);
+    retain->overflow = true;
+    return;
+  }
+  retain->len += (long)n;
+}
+
+static bool fill_input(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+
+  if (data->state.in_mem != NULL) {
+    /* Decompress straight from the caller's memory without copying.
+       The whole input is supplied at once, so this is only done once
+       unless rewinding. */
+    size_t const offset = in_start(data) + (size_t)data->state.in_total;
+    assert(offset <= data->state.in_mem_size);
+    size_t const avail = data->state.in_mem_size - offset;
+    assert(avail <= LONG_MAX);
+    data->state.params.in_buffer = &*data->state.in_mem + offset;
+    data->state.params.in_size = (size_t)in_limit(data, (long)avail);
+    data->state.in_total += (long)data->state.params.in_size;
+    return true;
+  }
+
+  data->state.params.in_buffer = data->buffer.in;
+
+  if (retaining(data) && data->state.in_total < data->retain.len) {
+    /* Read compressed data again after rewinding */
+    assert(data->retain.buf != NULL);
+    long int const avail = data->retain.len - data->state.in_total;
+    size_t const n = (unsigned long)avail < sizeof(data->buffer.in) ?
+                     (size_t)avail : sizeof(data->buffer.in);
+
+    data->state.params.in_size = spillbuf_read(&*data->retain.buf,
+                                               data->state.in_total,
+                                               data->buffer.in, n);
+    if (data->state.params.in_size != n) {
+      DEBUGF("Failed to read retained compressed data\n");
+      reader->error = 1;
+      return false;
+    }
+  } else {
+    size_t const n = (size_t)in_limit(data, sizeof(data->buffer.in));
+    data->state.params.in_size =
+      reader_fread(data->buffer.in, 1, n, data->state.backend);
+
+    if (data->state.params.in_size != n &&
+        reader_ferror(data->state.backend)) {
+      /* Read error not end of file */
+      DEBUGF("Failed to read compressed data from file\n");
+      reader->error = 1;
+      return false;
+    }
+    retain_input(data, data->state.params.in_size);
+  }
+
+  DEBUG_VERBOSEF("Filled input buffer with %zu bytes of compressed data\n",
+                 data->state.params.in_size);
+  data->state.in_total += (long)data->state.params.in_size;
+  return true;
 }
 
 static long int read_core(_Optional char *ptr,
@@ -128,27 +388,36 @@ static long int read_core(_Optional char *ptr,
       GKeyStatus status = GKeyStatus_OK;
 
       assert(data->state.out_ptr == data->state.params.out_buffer);
-      prepare_for_output(data);
-      data->state.params.out_size = sizeof(data->buffer.out);
+
+      /* Decompress straight into the caller's buffer if it can hold at
+         least as much as the output buffer. Never decompress beyond the
+         end of the data (which may be followed by another member). */
+      long int const n_left = bytes_to_read - bytes_read;
+      long int const out_left =
+        data->state.out_len - (data->state.out_total + bytes_read);
+      assert(out_left >= n_left);
+      bool const direct = ptr && n_left >= BUFFER_SIZE;
+      size_t out_size = sizeof(data->buffer.out);
+      if (direct) {
+        out_size = (size_t)n_left;
+      } else if (out_left < BUFFER_SIZE) {
+        out_size = (size_t)out_left;
+      }
+      if (direct) {
+        DEBUG_VERBOSEF("Decompressing %zu bytes directly\n", out_size);
+        data->state.out_ptr = &*ptr;
+        data->state.params.out_buffer = &*ptr;
+      } else {
+        prepare_for_output(data);
+      }
+      data->state.params.out_size = out_size;
+
+      const char *const out_start = data->state.params.out_buffer;
 
       do {
         /* Is the input buffer empty? */
-        if (data->state.params.in_size == 0) {
-          /* Fill the input buffer by reading from file */
-          data->state.params.in_buffer = data->buffer.in;
-          data->state.params.in_size = reader_fread(
-            data->buffer.in, 1, sizeof(data->buffer.in), data->state.backend);
-
-          DEBUG_VERBOSEF(
-            "Filled input buffer with %zu bytes of compressed data\n",
-            data->state.params.in_size);
-          if (data->state.params.in_size != sizeof(data->buffer.in) &&
-              reader_ferror(data->state.backend)) {
-            /* Read error not end of file */
-            DEBUGF("Failed to read compressed data from file\n");
-            reader->error = 1;
-            break;
-          }
+        if (data->state.params.in_size == 0 && !fill_input(reader)) {
+          break;
         }
 
         /* Decompress the data from the input buffer to the output buffer */
@@ -156,9 +425,7 @@ static long int read_core(_Optional char *ptr,
 
         /* If the input buffer is empty and it cannot be (re-)filled then
            there is no more input pending. */
-        in_pending = data->state.params.in_size > 0 ||
-                     (!reader_feof(data->state.backend) &&
-                      !reader_ferror(data->state.backend));
+        in_pending = input_pending(data);
 
         if (in_pending && status == GKeyStatus_TruncatedInput) {
           /* False alarm before end of input data */
@@ -168,7 +435,10 @@ static long int read_core(_Optional char *ptr,
 
       DEBUG_VERBOSEF(
         "Filled output buffer with %zu bytes of uncompressed data\n",
-        sizeof(data->buffer.out) - data->state.params.out_size);
+        out_size - data->state.params.out_size);
+
+      history_append(&data->history, out_start,
+                     out_size - data->state.params.out_size);
 
       if (!reader->error) {
         switch (status) {
@@ -190,7 +460,7 @@ static long int read_core(_Optional char *ptr,
 
         case GKeyStatus_OK:
           assert(!in_pending);
-          if (data->state.params.out_size == sizeof(data->buffer.out)) {
+          if (data->state.params.out_size == out_size) {
             DEBUGF("Compressed bitstream appears truncated\n");
             reader->error = 1;
           }
@@ -201,6 +471,16 @@ static long int read_core(_Optional char *ptr,
           break;
         }
       }
+
+      if (direct) {
+        /* Nothing is left in the output buffer to seek back into */
+        assert(ptr);
+        long int const produced = (long)(out_size -
+                                         data->state.params.out_size);
+        ptr = ptr + produced;
+        bytes_read += produced;
+        prepare_for_output(data);
+      }
     }
   }
 
@@ -208,27 +488,180 @@ static long int read_core(_Optional char *ptr,
   return bytes_read;
 }
 
+static bool read_uint64(uint64_t *const val, Reader *const reader)
+{
+  assert(val != NULL);
+  assert(reader != NULL);
+
+  uint32_t lo, hi;
+  if (!reader_fread_uint32(&lo, reader) ||
+      !reader_fread_uint32(&hi, reader)) {
+    return false;
+  }
+  *val = ((uint64_t)hi << 32) | lo;
+  return true;
+}
+
+static bool read_ext_hdr(ReaderGKeyData *const data, uint64_t *const out_len)
+{
+  assert(data != NULL);
+  assert(out_len != NULL);
+
+  uint32_t version;
+  if (!reader_fread_uint32(&version, data->state.backend) ||
+      !read_uint64(out_len, data->state.backend)) {
+    DEBUGF("Failed to read extended header\n");
+    return false;
+  }
+
+  /* The only flag defined so far is the member flag */
+  if ((version & GKeyHdr_VersionMask) != GKeyHdr_Version ||
+      (version & ~(uint32_t)(GKeyHdr_VersionMask | GKeyHdr_Member)) != 0) {
+    DEBUGF("Unsupported header version/flags 0x%" PRIx32 "\n", version);
+    return false;
+  }
+
+  data->state.members = (version & GKeyHdr_Member) != 0;
+  if (!data->state.members) {
+    data->state.hdr_size = GKeyHdr_ExtendedSize;
+    return true;
+  }
+
+  uint64_t in_len;
+  if (!read_uint64(&in_len, data->state.backend)) {
+    DEBUGF("Failed to read compressed size\n");
+    return false;
+  }
+
+  DEBUGF("Compressed member size is %" PRIu64 " bytes\n", in_len);
+  if (in_len > LONG_MAX) {
+    DEBUGF("Compressed size %" PRIu64 " is too big\n", in_len);
+    return false;
+  }
+
+  data->state.in_len = (long)in_len;
+  data->state.hdr_size = GKeyHdr_MemberSize;
+  return true;
+}
+
 static bool read_hdr(ReaderGKeyData *const data)
 {
   assert(data != NULL);
 
-  int32_t out_len;
-  if (!reader_fread_int32(&out_len, data->state.backend)) {
+  bool const members = data->state.members;
+  data->state.hdr_pos = reader_ftell(data->state.backend);
+
+  int32_t len32;
+  if (!reader_fread_int32(&len32, data->state.backend)) {
     DEBUGF("Failed to read decompressed size: %s\n",
            reader_feof(data->state.backend) ? "End of file" : "Error");
     return false;
   }
 
-  DEBUGF("Decompressed data size is %" PRId32 " bytes\n", out_len);
-  if (out_len < 0) {
-    DEBUGF("Bad size %" PRId32 " in compressed file\n", out_len);
+  uint64_t out_len;
+  if (len32 == GKeyHdr_Marker) {
+    if (!read_ext_hdr(data, &out_len)) {
+      return false;
+    }
+  } else if (len32 < 0) {
+    DEBUGF("Bad size %" PRId32 " in compressed file\n", len32);
+    return false;
+  } else {
+    out_len = (uint32_t)len32;
+    data->state.members = false;
+    data->state.hdr_size = GKeyHdr_ClassicSize;
+  }
+
+  if (members && !data->state.members) {
+    DEBUGF("Expected another member at %ld\n", data->state.hdr_pos);
     return false;
   }
 
-  data->state.out_len = out_len;
+  /* The size of a member is relative to the end of the previous one */
+  DEBUGF("Decompressed data size is %" PRIu64 " bytes\n", out_len);
+  assert(data->state.out_total >= 0);
+  if (out_len > (unsigned long)(LONG_MAX - data->state.out_total)) {
+    DEBUGF("Size %" PRIu64 " in compressed file is too big\n", out_len);
+    return false;
+  }
+
+  data->state.out_len = data->state.out_total + (long)out_len;
   return true;
 }
 
+static bool next_member(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+  assert(data->state.members);
+  assert(data->state.out_total == data->state.out_len);
+
+  /* Any compressed data not needed to produce the expected output
+     must be skipped (but normally there is none) */
+  long int const next = (long)in_start(data) + data->state.in_len;
+  if (reader_fseek(data->state.backend, next, SEEK_SET)) {
+    reader->error = 1;
+    return false;
+  }
+
+  int const c = reader_fgetc(data->state.backend);
+  if (c == EOF) {
+    if (reader_ferror(data->state.backend)) {
+      DEBUGF("Failed to read next member\n");
+      reader->error = 1;
+    } else {
+      DEBUGF("No more members at %ld\n", next);
+    }
+    return false;
+  }
+
+  if (reader_ungetc(c, data->state.backend) == EOF || !read_hdr(data)) {
+    reader->error = 1;
+    return false;
+  }
+
+  /* Each member is compressed independently */
+  gkeydecomp_reset(data->state.decomp);
+  data->state.params.in_size = 0;
+  data->state.in_total = 0;
+  return true;
+}
+
+static long int read_members(Reader *const reader, _Optional char *ptr,
+                             long int const bytes_to_read)
+{
+  assert(reader != NULL);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+
+  long int bytes_read = 0;
+  while (!reader->error && bytes_read < bytes_to_read) {
+    /* Don't try to read more bytes than advertised as available. */
+    assert(data->state.out_len >= data->state.out_total);
+    long int const avail = data->state.out_len - data->state.out_total;
+    if (avail == 0) {
+      if (!data->state.members || !next_member(reader)) {
+        break;
+      }
+      continue;
+    }
+
+    long int const n = bytes_to_read - bytes_read < avail ?
+                       bytes_to_read - bytes_read : avail;
+    long int const nread = read_core(ptr, n, reader);
+    assert(nread <= n);
+    bytes_read += nread;
+    if (nread != n) {
+      break;
+    }
+    if (ptr) {
+      ptr = ptr + nread;
+    }
+  }
+  return bytes_read;
+}
+
 static size_t reader_gkey_fread(void *const ptr, size_t bytes_to_read,
                                 Reader *const reader)
 {
@@ -250,18 +683,21 @@ static size_t reader_gkey_fread(void *const ptr, size_t bytes_to_read,
 
   /* If fseek was used since the last read then find the right
      position at which to start reading. */
-  if (reader->fpos > data->state.out_len) {
-    DEBUGF("Can't seek %ld beyond end %ld\n", reader->fpos,
-           data->state.out_len);
+  long int pos = reader->fpos;
+  if (pos > data->state.out_len && !data->state.members) {
+    DEBUGF("Can't seek %ld beyond end %ld\n", pos, data->state.out_len);
     reader->error = 1;
     return 0;
   }
 
-  if (reader->fpos != data->state.out_total) {
-    DEBUGF("Seeking offset %ld in file (out %ld)\n", reader->fpos,
+  char *dest = ptr;
+  size_t from_history = 0;
+
+  if (pos != data->state.out_total) {
+    DEBUGF("Seeking offset %ld in file (out %ld)\n", pos,
            data->state.out_total);
 
-    if (reader->fpos < data->state.out_total) {
+    if (pos < data->state.out_total) {
       assert(data->state.out_ptr >= data->buffer.out);
       ptrdiff_t const out_buf_used = data->state.out_ptr - data->buffer.out;
       DEBUGF("%td bytes of buffer were already output\n", out_buf_used);
@@ -270,52 +706,86 @@ static size_t reader_gkey_fread(void *const ptr, size_t bytes_to_read,
       long int const buf_start = data->state.out_total - (long)out_buf_used;
       DEBUGF("Buffer starts at offset %ld\n", buf_start);
 
-      if (reader->fpos >= buf_start) {
-        long int const buf_offset = reader->fpos - buf_start;
+      if (pos < buf_start) {
+        /* Serve as much as possible of the data before the output buffer
+           from the history of recently decompressed data. */
+        size_t const n = (unsigned long)(buf_start - pos) < bytes_to_read ?
+                         (size_t)(buf_start - pos) : bytes_to_read;
+
+        from_history = history_read(data, pos, dest, n);
+        pos += (long)from_history;
+        dest += from_history;
+        bytes_to_read -= from_history;
+        if (bytes_to_read == 0) {
+          return from_history;
+        }
+      }
+
+      if (pos >= buf_start) {
+        long int const buf_offset = pos - buf_start;
         DEBUGF("Seeking offset %ld in buffer\n", buf_offset);
-        data->state.out_total = reader->fpos;
+        data->state.out_total = pos;
         data->state.out_ptr = data->buffer.out + buf_offset;
       } else {
         /* Seeking backwards requires decompressing data
            from the start of the file to the requested place again. */
         DEBUGF("Seeking start of file for fread\n");
-        if (reader_fseek(data->state.backend, sizeof(uint32_t), SEEK_SET)) {
-          reader->error = 1;
-          return 0;
+        if (data->state.members) {
+          /* Start again from the first member */
+          gkeydecomp_reset(data->state.decomp);
+          rewind_reinit(data);
+          if (reader_fseek(data->state.backend, 0, SEEK_SET) ||
+              !read_hdr(data)) {
+            reader->error = 1;
+            return 0;
+          }
+        } else {
+          if (!can_reread(data) &&
+              reader_fseek(data->state.backend, data->state.hdr_size,
+                           SEEK_SET)) {
+            reader->error = 1;
+            return 0;
+          }
+          gkeydecomp_reset(data->state.decomp);
+          rewind_reinit(data);
         }
-        rewind_reinit(data);
       }
     }
 
-    long int const bytes_to_skip = reader->fpos - data->state.out_total;
+    long int const bytes_to_skip = pos - data->state.out_total;
     DEBUGF("Skipping %ld bytes\n", bytes_to_skip);
-    long int const nskipped = read_core(NULL, bytes_to_skip, reader);
+    long int const nskipped = read_members(reader, NULL, bytes_to_skip);
 
     assert(nskipped <= bytes_to_skip);
     if (nskipped != bytes_to_skip) {
+      DEBUGF("Can't seek %ld beyond end %ld\n", pos, data->state.out_total);
+      reader->error = 1;
       return 0;
     }
 
-    DEBUGF("Successfully repositioned to %ld\n", reader->fpos);
+    DEBUGF("Successfully repositioned to %ld\n", pos);
   }
 
-  /* Don't try to read more bytes than advertised as available. */
-  assert(data->state.out_len >= data->state.out_total);
-  long int const avail = data->state.out_len - data->state.out_total;
-  long int actual_bytes_to_read = (long)bytes_to_read;
-  assert((unsigned long)actual_bytes_to_read == bytes_to_read);
-
-  if (avail < actual_bytes_to_read) {
-    DEBUGF("Can't read %zu bytes: end of file at %ld\n", bytes_to_read, avail);
+  assert(bytes_to_read <= LONG_MAX);
+  long int const nread = read_members(reader, dest, (long)bytes_to_read);
+  assert((unsigned long)nread <= bytes_to_read);
 
-    actual_bytes_to_read = avail;
+  if ((unsigned long)nread < bytes_to_read &&
+      data->state.out_total == data->state.out_len) {
+    DEBUGF("Can't read %zu bytes: end of file at %ld\n", bytes_to_read,
+           data->state.out_len);
     reader->eof = 1;
   }
 
-  long int const nread = read_core(ptr, actual_bytes_to_read, reader);
-  assert(nread <= actual_bytes_to_read);
-  assert((unsigned long)nread == (size_t)nread);
-  return (size_t)nread;
+  return from_history + (size_t)nread;
+}
+
+static void detach(ReaderGKeyData *const data)
+{
+  assert(data != NULL);
+  if (data->state.owns_backend) {
+    reader_destroy(data->state.backend);
+  }
 }
 
 static void reader_gkey_destroy(Reader *const reader)
@@ -323,32 +793,29 @@ static void reader_gkey_destroy(Reader *const reader)
   assert(reader != NULL);
   ReaderGKeyData *const data = reader->data;
   assert(data != NULL);
+  detach(data);
   gkeydecomp_destroy(data->state.decomp);
-  if (data->state.owns_backend) {
-    reader_destroy(data->state.backend);
-    free(data->state.backend);
-  }
+  free(data->history.buf);
+  spillbuf_destroy(data->retain.buf);
   free(data);
 }
 
-bool reader_gkey_init_from(Reader *const reader,
-                           unsigned int const history_log_2, Reader *const in)
+static void attach(Reader *const reader, ReaderGKeyData *const data,
+                   Reader *const in, bool const owns_backend)
 {
   assert(reader != NULL);
+  assert(data != NULL);
   assert(in != NULL);
   assert(!reader_ferror(in));
   assert(!reader_feof(in));
 
-  _Optional ReaderGKeyData *const data = malloc(sizeof(*data));
-  if (data == NULL) {
-    DEBUGF("Failed to allocate memory for a new reader\n");
-    return false;
-  }
+  GKeyDecomp *const decomp = data->state.decomp;
 
   data->state = (ReaderGKeyState){
     .backend = in,
-    .owns_backend = false,
+    .owns_backend = owns_backend,
     .read_hdr = false,
+    .decomp = decomp,
     .params =
       {
         .prog_cb = (GKeyProgressFn *)NULL,
@@ -356,18 +823,45 @@ bool reader_gkey_init_from(Reader *const reader,
       },
   };
 
+  static ReaderFns const fns = {reader_gkey_fread, reader_gkey_destroy, NULL};
+  reader_internal_init(reader, &fns, data);
+  rewind_reinit(data);
+  data->retain.len = 0;
+  data->retain.overflow = false;
+}
+
+static _Optional ReaderGKeyData *make_data(unsigned int const history_log_2)
+{
+  _Optional ReaderGKeyData *const data = malloc(sizeof(*data));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return NULL;
+  }
+
   _Optional GKeyDecomp *const decomp = gkeydecomp_make(history_log_2);
   if (decomp == NULL) {
     DEBUGF("Failed to create decompressor\n");
     free(data);
-    return false;
+    return NULL;
   }
   data->state.decomp = &*decomp;
+  data->history = (ReaderGKeyHistory){.buf = NULL, .size = 0};
+  data->retain = (ReaderGKeyRetain){.buf = NULL, .limit = 0};
+  return data;
+}
+
+bool reader_gkey_init_from(Reader *const reader,
+                           unsigned int const history_log_2, Reader *const in)
+{
+  assert(reader != NULL);
+  assert(in != NULL);
 
-  static ReaderFns const fns = {reader_gkey_fread, reader_gkey_destroy};
-  reader_internal_init(reader, &fns, &*data);
-  rewind_reinit(&*data);
+  _Optional ReaderGKeyData *const data = make_data(history_log_2);
+  if (data == NULL) {
+    return false;
+  }
 
+  attach(reader, &*data, in, false);
   return true;
 }
 
@@ -379,24 +873,113 @@ bool reader_gkey_init(Reader *const reader, unsigned int const history_log_2,
   assert(!ferror(in));
   assert(!feof(in));
 
-  _Optional Reader *const raw = malloc(sizeof(*raw));
-  if (raw == NULL) {
-    DEBUGF("Failed to allocate raw backend\n");
+  _Optional ReaderGKeyData *const data = make_data(history_log_2);
+  if (data == NULL) {
+    DEBUGF("Failed to initialize a new reader\n");
     return false;
   }
 
-  reader_raw_init(&*raw, in);
+  reader_raw_init(&data->raw, in);
+  attach(reader, &*data, &data->raw, true);
+  return true;
+}
 
-  bool const success = reader_gkey_init_from(reader, history_log_2, &*raw);
+bool reader_gkey_init_mem(Reader *const reader,
+                          unsigned int const history_log_2,
+                          const void *const buf, size_t const size)
+{
+  assert(reader != NULL);
+  assert(buf != NULL);
+  assert(size <= LONG_MAX);
 
-  if (!success) {
+  _Optional ReaderGKeyData *const data = make_data(history_log_2);
+  if (data == NULL) {
     DEBUGF("Failed to initialize a new reader\n");
-    reader_destroy(&*raw);
-    free(raw);
-  } else {
-    ReaderGKeyData *const data = reader->data;
-    data->state.owns_backend = true; /* override default */
+    return false;
+  }
+
+  /* The backend is only used to read the header */
+  if (!reader_mem_init(&data->raw, buf, size)) {
+    gkeydecomp_destroy(data->state.decomp);
+    free(data);
+    return false;
+  }
+
+  attach(reader, &*data, &data->raw, true);
+  data->state.in_mem = buf;
+  data->state.in_mem_size = size;
+  return true;
+}
+
+void reader_gkey_reinit_from(Reader *const reader, Reader *const in)
+{
+  assert(reader != NULL);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+  assert(in != NULL);
+
+  detach(data);
+  gkeydecomp_reset(data->state.decomp);
+  attach(reader, data, in, false);
+}
+
+void reader_gkey_reinit(Reader *const reader, FILE *const in)
+{
+  assert(reader != NULL);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+  assert(in != NULL);
+  assert(!ferror(in));
+  assert(!feof(in));
+
+  detach(data);
+  gkeydecomp_reset(data->state.decomp);
+  reader_raw_init(&data->raw, in);
+  attach(reader, data, &data->raw, true);
+}
+
+bool reader_gkey_set_history(Reader *const reader, size_t const size)
+{
+  assert(reader != NULL);
+  assert(reader->fns.fread_fn == reader_gkey_fread);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+
+  _Optional char *buf = NULL;
+  if (size > 0) {
+    buf = malloc(size);
+    if (buf == NULL) {
+      DEBUGF("Failed to allocate %zu bytes of history\n", size);
+      return false;
+    }
   }
 
-  return success;
+  /* Earlier data is not retained */
+  free(data->history.buf);
+  data->history = (ReaderGKeyHistory){.buf = buf, .size = size};
+  return true;
+}
+
+bool reader_gkey_set_retain(Reader *const reader, size_t const threshold,
+                            long int const limit)
+{
+  assert(reader != NULL);
+  assert(reader->fns.fread_fn == reader_gkey_fread);
+  ReaderGKeyData *const data = reader->data;
+  assert(data != NULL);
+  assert(!data->state.read_hdr);
+  assert(limit >= 0);
+
+  _Optional SpillBuf *buf = NULL;
+  if (limit > 0) {
+    buf = spillbuf_make(threshold);
+    if (buf == NULL) {
+      DEBUGF("Failed to create buffer for compressed input\n");
+      return false;
+    }
+  }
+
+  spillbuf_destroy(data->retain.buf);
+  data->retain = (ReaderGKeyRetain){.buf = buf, .limit = limit};
+  return true;
 }
@@ -25,6 +25,11 @@ History:
   CJB: 01-Sep-19: Added function documentation.
   CJB: 21-Sep-19: Add missing #include.
   CJB: 28-Jul-22: Removed redundant use of the 'extern' keyword.
+  CJB: 18-Oct-26: Added reader_gkey_reinit and reader_gkey_reinit_from.
+                  Added reader_gkey_set_history and reader_gkey_set_retain.
+                  Added reader_gkey_init_mem.
+                  Recognise the extended header.
+                  Read multi-member streams.
 */
 
 #ifndef ReaderGKey_h
@@ -44,7 +49,11 @@ bool reader_gkey_init(Reader * /*reader*/, unsigned int /*history_log_2*/,
  * has been encoded in Gordon Key's compressed format to be read as
  * though it were not thus encoded. The 'history_log_2' parameter is the
  * number of bytes to look behind, in base 2 logarithmic form, and must
- * be the same as that used to compress the data.
+ * be the same as that used to compress the data. Both the classic
+ * header with a 32-bit size and the extended header written by a writer
+ * object after calling writer_gkey_set_extended are recognised.
+ * Consecutive members of a multi-member stream (see
+ * writer_gkey_set_members) are read as one continuous stream.
  * Returns: true if successful, otherwise false. Can only fail because of
  *          lack of free memory.
  */
@@ -62,4 +71,70 @@ bool reader_gkey_init_from(Reader * /*reader*/, unsigned int /*history_log_2*/,
  *          lack of free memory.
  */
 
+bool reader_gkey_init_mem(Reader * /*reader*/,
+                          unsigned int /*history_log_2*/,
+                          const void * /*buf*/, size_t /*size*/);
+/*
+ * creates an abstract reader object to allow 'size' bytes of data
+ * encoded in Gordon Key's compressed format, which are stored in the
+ * array pointed to by 'buf', to be read as though they were not thus
+ * encoded. The data is decompressed straight from the array, which must
+ * not be modified or freed until the reader has been destroyed. Seeking
+ * backward never requires the data to be copied. The 'history_log_2'
+ * parameter is as for reader_gkey_init.
+ * Returns: true if successful, otherwise false. Can only fail because of
+ *          lack of free memory.
+ */
+
+void reader_gkey_reinit_from(Reader * /*reader*/, Reader * /*in*/);
+/*
+ * resets an abstract reader object created by reader_gkey_init or
+ * reader_gkey_init_from to allow data from the reader object pointed to
+ * by 'in' to be decompressed on the fly. This is equivalent to destroying
+ * the reader and creating a new one with the same 'history_log_2' but
+ * avoids freeing and reallocating the decompressor's state. Any reader
+ * object that was implicitly created by reader_gkey_init is destroyed.
+ */
+
+void reader_gkey_reinit(Reader * /*reader*/, FILE * /*in*/);
+/*
+ * resets an abstract reader object created by reader_gkey_init or
+ * reader_gkey_init_from to allow the contents of the file pointed to by
+ * 'in' to be read. This function is similar to reader_gkey_reinit_from
+ * except that it implicitly creates a reader object to allow the file to
+ * be read. (The second reader is implicitly destroyed with its parent.)
+ */
+
+bool reader_gkey_set_history(Reader * /*reader*/, size_t /*size*/);
+/*
+ * sets the size of a ring buffer in which a reader object created by
+ * reader_gkey_init or reader_gkey_init_from retains the most recently
+ * decompressed data. A backward seek to a position within the last 'size'
+ * bytes is then served from memory instead of by decompressing the data
+ * again from the start of the file. A size of 0 (the default) disables
+ * the history. Any data already retained is discarded. The size is kept
+ * if the reader is reinitialized.
+ * Returns: true if successful, otherwise false. Can only fail because of
+ *          lack of free memory, in which case the previous history is kept.
+ */
+
+bool reader_gkey_set_retain(Reader * /*reader*/, size_t /*threshold*/,
+                            long int /*limit*/);
+/*
+ * makes a reader object created by reader_gkey_init or reader_gkey_init_from
+ * retain up to 'limit' bytes of the compressed data that it reads, so that
+ * seeking backward beyond the start of any history (see
+ * reader_gkey_set_history) can be done without seeking the backend. This
+ * allows rewinding data read from a pipe or other non-seekable source.
+ * The retained data is stored in memory until its size would exceed
+ * 'threshold' bytes, and in a temporary file thereafter. If the compressed
+ * data is longer than 'limit' then rewinding requires the backend to be
+ * seekable, as it does by default. A limit of 0 disables retention. Must
+ * be called before any data is read. Reinitializing the reader keeps the
+ * limits but discards any retained data. Input from a multi-member stream
+ * is never retained.
+ * Returns: true if successful, otherwise false. Can only fail because of
+ *          lack of free memory, in which case the previous limits are kept.
+ */
+
 #endif /* ReaderGKey_h */
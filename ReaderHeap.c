@@ -0,0 +1,103 @@
+/*
+ * StreamLib: Reallocating memory buffer reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderHeap.h"
+#include "WriterHeap.h"
+
+static size_t reader_heap_fread(void *ptr, size_t const size,
+                                Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  Writer const *const writer = reader->data;
+  assert(writer != NULL);
+  assert(reader->fpos >= 0);
+
+  /* Only data that has already been written is visible. */
+  long int const len = writer->flen;
+  if (reader->fpos > len) {
+    DEBUGF("Can't seek beyond end at %ld\n", len);
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t nread = size;
+  if ((unsigned long)(len - reader->fpos) < nread) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+    nread = (size_t)(len - reader->fpos);
+  }
+  DEBUGF("Reading %zu of %zu bytes\n", nread, size);
+
+  if (nread > 0) {
+    /* The buffer may have moved since the last read. */
+    _Optional void *const buffer = writer_heap_buffer(writer);
+    assert(buffer != NULL);
+    memcpy(ptr, (char *)buffer + reader->fpos, nread);
+  }
+
+  return nread;
+}
+
+static _Optional const void *reader_heap_peek(size_t *const size,
+                                              Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  Writer const *const writer = reader->data;
+  assert(writer != NULL);
+  assert(reader->fpos >= 0);
+
+  if (reader->fpos >= writer->flen) {
+    return NULL;
+  }
+
+  _Optional void *const buffer = writer_heap_buffer(writer);
+  assert(buffer != NULL);
+  *size = (size_t)(writer->flen - reader->fpos);
+  return (char *)buffer + reader->fpos;
+}
+
+static void reader_heap_destroy(Reader *const reader)
+{
+  NOT_USED(reader);
+}
+
+void reader_heap_init(Reader *const reader, Writer const *const writer)
+{
+  assert(reader != NULL);
+  assert(writer != NULL);
+
+  static ReaderFns const fns = {reader_heap_fread, reader_heap_destroy,
+                                reader_heap_peek};
+  /* The data pointer isn't const-qualified but this reader never writes
+     through it. */
+  reader_internal_init(reader, &fns, (Writer *)writer);
+}
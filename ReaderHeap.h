@@ -0,0 +1,46 @@
+/*
+ * StreamLib: Reallocating memory buffer reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderHeap_h
+#define ReaderHeap_h
+
+/* Local header files */
+#include "Reader.h"
+#include "Writer.h"
+
+void reader_heap_init(Reader * /*reader*/, Writer const * /*writer*/);
+/*
+ * creates an abstract reader object to allow data to be read from the
+ * buffer of a writer object that was created by writer_heap_init or
+ * writer_heap_init_with_alloc, whilst that writer is still in use. The
+ * size of the input is the length of the data written so far, so it may
+ * increase between reads; reading beyond it sets the end-of-file
+ * indicator, which can be cleared by calling reader_fseek. The reader
+ * object must be destroyed before the writer object. See also
+ * writer_heap_to_reader.
+ */
+
+#endif /* ReaderHeap_h */
@@ -22,6 +22,7 @@
   CJB: 07-Sep-19: First released version.
   CJB: 28-Nov-20: Initialize struct using compound literal assignment.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
+  CJB: 18-Oct-26: Added a peek function.
 */
 
 /* ISO library header files */
@@ -74,6 +75,24 @@ static size_t reader_mem_fread(void *ptr, size_t const size,
   return nread;
 }
 
+static _Optional const void *reader_mem_peek(size_t *const size,
+                                             Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderMemData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  if ((unsigned long)reader->fpos >= data->buffer_size) {
+    return NULL;
+  }
+
+  *size = data->buffer_size - (size_t)reader->fpos;
+  assert(data->buffer != NULL);
+  return data->buffer + reader->fpos;
+}
+
 static void reader_mem_destroy(Reader *const reader)
 {
   assert(reader != NULL);
@@ -97,7 +116,8 @@ bool reader_mem_init(Reader *const reader, const void *const buffer,
     .buffer_size = buffer_size,
   };
 
-  static ReaderFns const fns = {reader_mem_fread, reader_mem_destroy};
+  static ReaderFns const fns = {reader_mem_fread, reader_mem_destroy,
+                                reader_mem_peek};
   reader_internal_init(reader, &fns, &*data);
 
   return true;
@@ -51,6 +51,6 @@ static void reader_null_destroy(Reader *const reader)
 void reader_null_init(Reader *const reader)
 {
   assert(reader != NULL);
-  static ReaderFns const fns = {reader_null_fread, reader_null_destroy};
+  static ReaderFns const fns = {reader_null_fread, reader_null_destroy, NULL};
   reader_internal_init(reader, &fns, reader);
 }
@@ -0,0 +1,53 @@
+/*
+ * StreamLib: Peek at input without copying it
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdio.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "Reader.h"
+
+_Optional const void *reader_fpeek(Reader *const reader, size_t *const size)
+{
+  assert(reader != NULL);
+  assert(size != NULL);
+  assert(reader->fpos >= 0);
+
+  *size = 0;
+
+  /* A pushed-back character isn't stored where the backend can find it */
+  if (reader->eof || reader->error || reader->pushed_back != EOF ||
+      reader->fns.peek_fn == NULL) {
+    return NULL;
+  }
+
+  _Optional const void *const ptr = reader->fns.peek_fn(size, reader);
+  if (ptr == NULL || *size == 0) {
+    *size = 0;
+    return NULL;
+  }
+
+  DEBUG_VERBOSEF("Peeked %zu bytes at %ld\n", *size, reader->fpos);
+  return ptr;
+}
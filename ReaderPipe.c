@@ -0,0 +1,134 @@
+/*
+ * StreamLib: Pipe reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  An empty pipe no longer sets the end-of-file indicator.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderPipe.h"
+
+enum {
+  SkipBufferSize = 256,
+};
+
+typedef struct {
+  Pipe *pipe;
+  long int pos; /* number of bytes read from the pipe */
+  bool blocking;
+} ReaderPipeData;
+
+static bool skip(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderPipeData *const data = reader->data;
+  assert(data != NULL);
+
+  /* A pipe can't be rewound, but seeking forward can be simulated by
+     discarding data. */
+  if (reader->fpos < data->pos) {
+    DEBUGF("Can't seek backward from %ld to %ld\n", data->pos, reader->fpos);
+    reader->error = 1;
+    return false;
+  }
+
+  while (data->pos < reader->fpos) {
+    char tmp[SkipBufferSize];
+    size_t n = sizeof(tmp);
+    if ((unsigned long)(reader->fpos - data->pos) < n) {
+      n = (size_t)(reader->fpos - data->pos);
+    }
+
+    size_t const nread = pipe_read(data->pipe, tmp, n, data->blocking);
+    data->pos += (long)nread;
+    if (nread != n) {
+      /* A lack of data isn't the end, so the caller can try again later */
+      if (pipe_eof(data->pipe)) {
+        DEBUGF("set eof while skipping to %ld\n", reader->fpos);
+        reader->eof = 1;
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static size_t reader_pipe_fread(void *ptr, size_t const size,
+                                Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderPipeData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  if (reader->fpos != data->pos && !skip(reader)) {
+    return 0;
+  }
+
+  size_t const nread = pipe_read(data->pipe, ptr, size, data->blocking);
+  data->pos += (long)nread;
+  if (nread != size && pipe_eof(data->pipe)) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+  }
+  DEBUG_VERBOSEF("Read %zu of %zu bytes\n", nread, size);
+
+  return nread;
+}
+
+static void reader_pipe_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderPipeData *const data = reader->data;
+  assert(data != NULL);
+  pipe_close_read(data->pipe);
+  free(data);
+}
+
+bool reader_pipe_init(Reader *const reader, Pipe *const pipe,
+                      bool const blocking)
+{
+  assert(reader != NULL);
+  assert(pipe != NULL);
+
+  _Optional ReaderPipeData *const data = malloc(sizeof(*data));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  *data = (ReaderPipeData){
+    .pipe = pipe,
+    .pos = 0,
+    .blocking = blocking,
+  };
+
+  static ReaderFns const fns = {reader_pipe_fread, reader_pipe_destroy, NULL};
+  reader_internal_init(reader, &fns, &*data);
+
+  return true;
+}
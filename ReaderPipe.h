@@ -0,0 +1,55 @@
+/*
+ * StreamLib: Pipe reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library, POSIX threads.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  An empty pipe no longer sets the end-of-file indicator.
+*/
+
+#ifndef ReaderPipe_h
+#define ReaderPipe_h
+
+/* ISO library header files */
+#include <stdbool.h>
+
+/* Local header files */
+#include "Pipe.h"
+#include "Reader.h"
+
+bool reader_pipe_init(Reader * /*reader*/, Pipe * /*pipe*/,
+                      bool /*blocking*/);
+/*
+ * creates an abstract reader object to allow data to be read from the
+ * consumer's end of a pipe, typically in a different thread from the
+ * writer object at the producer's end. If 'blocking' is true then reads
+ * wait for data; otherwise a read only returns the data that is already
+ * available. The end-of-file indicator is only set once the producer has
+ * closed the pipe and all of its data has been read (see pipe_eof), so a
+ * short read without either indicator set means that no more data is
+ * available yet and the read can be retried later. Seeking forward
+ * discards data but seeking backward is not supported. Destroying the
+ * reader closes the consumer's end.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* ReaderPipe_h */
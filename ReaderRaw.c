@@ -22,6 +22,7 @@
   CJB: 11-Aug-19: Extra DEBUGF and const qualifiers.
   CJB: 27-Oct-19: Only call strerror (for debug output) if ferror.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
+  CJB: 18-Oct-26: Added reader_raw_file.
 */
 
 /* ISO library header files */
@@ -86,6 +87,12 @@ void reader_raw_init(Reader *const reader, FILE *const in)
   assert(!ferror(in));
   assert(!feof(in));
 
-  static ReaderFns const fns = {reader_raw_fread, reader_raw_destroy};
+  static ReaderFns const fns = {reader_raw_fread, reader_raw_destroy, NULL};
   reader_internal_init(reader, &fns, in);
 }
+
+_Optional FILE *reader_raw_file(Reader const *const reader)
+{
+  assert(reader != NULL);
+  return reader->fns.fread_fn == reader_raw_fread ? reader->data : NULL;
+}
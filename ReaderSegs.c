@@ -0,0 +1,178 @@
+/*
+ * StreamLib: Discontiguous memory segments reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderSegs.h"
+
+typedef struct {
+  ReaderSegment const *segs;
+  size_t nsegs;
+  size_t cur; /* index of the segment accessed most recently */
+  long int offsets[]; /* start of each segment, then the total size */
+} ReaderSegsData;
+
+static size_t find_segment(ReaderSegsData *const data, long int const pos)
+{
+  assert(data != NULL);
+  assert(pos >= 0);
+  assert(pos < data->offsets[data->nsegs]);
+
+  /* Sequential reads usually hit the current or next segment. */
+  size_t const cur = data->cur;
+  if (data->offsets[cur] <= pos && pos < data->offsets[cur + 1]) {
+    return cur;
+  }
+  if (cur + 1 < data->nsegs && data->offsets[cur + 1] <= pos &&
+      pos < data->offsets[cur + 2]) {
+    return data->cur = cur + 1;
+  }
+
+  /* Find the last segment that starts at or before the given position.
+     Any empty segments before it start at the same offset. */
+  size_t lo = 0, hi = data->nsegs - 1;
+  while (lo < hi) {
+    size_t const mid = lo + (hi - lo + 1) / 2;
+    if (data->offsets[mid] <= pos) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  assert(data->offsets[lo] <= pos);
+  assert(pos < data->offsets[lo + 1]);
+  DEBUG_VERBOSEF("Offset %ld is in segment %zu\n", pos, lo);
+  return data->cur = lo;
+}
+
+static size_t reader_segs_fread(void *ptr, size_t const size,
+                                Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderSegsData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  long int const len = data->offsets[data->nsegs];
+  if (reader->fpos > len) {
+    DEBUGF("Can't seek beyond end at %ld\n", len);
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t done = 0;
+  long int pos = reader->fpos;
+  while (done < size && pos < len) {
+    size_t const i = find_segment(data, pos);
+    size_t const offset = (size_t)(pos - data->offsets[i]);
+    size_t n = data->segs[i].size - offset;
+    if (n > size - done) {
+      n = size - done;
+    }
+
+    memcpy((char *)ptr + done, (char const *)data->segs[i].base + offset, n);
+    done += n;
+    pos += (long)n;
+  }
+
+  if (done != size) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+  }
+  DEBUGF("Read %zu of %zu bytes\n", done, size);
+
+  return done;
+}
+
+static _Optional const void *reader_segs_peek(size_t *const size,
+                                              Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderSegsData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  if (reader->fpos >= data->offsets[data->nsegs]) {
+    return NULL;
+  }
+
+  size_t const i = find_segment(data, reader->fpos);
+  size_t const offset = (size_t)(reader->fpos - data->offsets[i]);
+  *size = data->segs[i].size - offset;
+  return (char const *)data->segs[i].base + offset;
+}
+
+static void reader_segs_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  free(reader->data);
+}
+
+bool reader_segments_init(Reader *const reader,
+                          ReaderSegment const *const segs, size_t const nsegs)
+{
+  assert(reader != NULL);
+  assert(nsegs == 0 || segs != NULL);
+
+  if (nsegs > (SIZE_MAX - sizeof(ReaderSegsData)) / sizeof(long int) - 1) {
+    DEBUGF("Too many segments\n");
+    return false;
+  }
+
+  _Optional ReaderSegsData *const data =
+    malloc(sizeof(*data) + (nsegs + 1) * sizeof(data->offsets[0]));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  data->segs = segs;
+  data->nsegs = nsegs;
+  data->cur = 0;
+
+  long int total = 0;
+  for (size_t i = 0; i < nsegs; ++i) {
+    assert(segs[i].size == 0 || segs[i].base != NULL);
+    assert(segs[i].size <= (unsigned long)(LONG_MAX - total));
+    data->offsets[i] = total;
+    total += (long)segs[i].size;
+  }
+  data->offsets[nsegs] = total;
+  DEBUGF("%zu segments total %ld bytes\n", nsegs, total);
+
+  static ReaderFns const fns = {reader_segs_fread, reader_segs_destroy,
+                                reader_segs_peek};
+  reader_internal_init(reader, &fns, &*data);
+
+  return true;
+}
@@ -0,0 +1,58 @@
+/*
+ * StreamLib: Discontiguous memory segments reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderSegs_h
+#define ReaderSegs_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local header files */
+#include "Reader.h"
+
+typedef struct {
+  const void *base;
+  size_t size;
+} ReaderSegment;
+
+bool reader_segments_init(Reader * /*reader*/,
+                          ReaderSegment const * /*segs*/, size_t /*nsegs*/);
+/*
+ * creates an abstract reader object to allow data to be read from an
+ * array of 'nsegs' memory segments pointed to by 'segs' as if they were
+ * one contiguous file. Each segment has a base address and a size (in
+ * bytes); empty segments are allowed. Neither the array nor the segments'
+ * contents are copied, so they must not be modified or freed until the
+ * reader object has been destroyed. The total size must not exceed
+ * LONG_MAX bytes. Functions attempting to read beyond the end of the
+ * last segment will return an error value and set the end-of-file
+ * indicator. Supports reader_fpeek, which gets data from one segment.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* ReaderSegs_h */
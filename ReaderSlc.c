@@ -0,0 +1,157 @@
+/*
+ * StreamLib: Sub-range of another reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderSlc.h"
+
+typedef struct {
+  Reader *parent;
+  long int offset, length;
+} ReaderSliceData;
+
+static bool seek_parent(Reader *const reader)
+{
+  assert(reader != NULL);
+  ReaderSliceData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos <= data->length);
+
+  /* The parent's position may have been changed by another user of the
+     same reader, so always seek (which is cheap unless the position
+     actually changes). */
+  if (reader_fseek(data->parent, data->offset + reader->fpos, SEEK_SET)) {
+    DEBUGF("Failed to seek parent to %ld\n", data->offset + reader->fpos);
+    reader->error = 1;
+    return false;
+  }
+  return true;
+}
+
+static size_t reader_slice_fread(void *ptr, size_t const size,
+                                 Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  ReaderSliceData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  if (reader->fpos > data->length) {
+    DEBUGF("Can't seek beyond end at %ld\n", data->length);
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t n = size;
+  if ((unsigned long)(data->length - reader->fpos) < n) {
+    DEBUGF("set eof\n");
+    reader->eof = 1;
+    n = (size_t)(data->length - reader->fpos);
+  }
+
+  if (n == 0 || !seek_parent(reader)) {
+    return 0;
+  }
+
+  size_t const nread = reader_fread(ptr, 1, n, data->parent);
+  if (nread != n) {
+    /* The parent is shorter than the slice or failed */
+    if (reader_ferror(data->parent)) {
+      DEBUGF("set error\n");
+      reader->error = 1;
+    } else {
+      DEBUGF("set eof\n");
+      reader->eof = 1;
+    }
+  }
+  DEBUGF("Read %zu of %zu bytes\n", nread, size);
+
+  return nread;
+}
+
+static _Optional const void *reader_slice_peek(size_t *const size,
+                                               Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  ReaderSliceData *const data = reader->data;
+  assert(data != NULL);
+  assert(reader->fpos >= 0);
+
+  if (reader->fpos >= data->length) {
+    return NULL;
+  }
+
+  /* Avoid setting the error indicator, as required for peek_fn */
+  if (reader_fseek(data->parent, data->offset + reader->fpos, SEEK_SET)) {
+    return NULL;
+  }
+
+  _Optional const void *const ptr = reader_fpeek(data->parent, size);
+  if ((unsigned long)(data->length - reader->fpos) < *size) {
+    *size = (size_t)(data->length - reader->fpos);
+  }
+  return ptr;
+}
+
+static void reader_slice_destroy(Reader *const reader)
+{
+  assert(reader != NULL);
+  free(reader->data);
+}
+
+bool reader_slice_init(Reader *const reader, Reader *const parent,
+                       long int const offset, long int const length)
+{
+  assert(reader != NULL);
+  assert(parent != NULL);
+  assert(reader != parent);
+  assert(offset >= 0);
+  assert(length >= 0);
+  assert(length <= LONG_MAX - offset);
+
+  _Optional ReaderSliceData *const data = malloc(sizeof(*data));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new reader\n");
+    return false;
+  }
+
+  *data = (ReaderSliceData){
+    .parent = parent,
+    .offset = offset,
+    .length = length,
+  };
+
+  static ReaderFns const fns = {reader_slice_fread, reader_slice_destroy,
+                                reader_slice_peek};
+  reader_internal_init(reader, &fns, &*data);
+
+  return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * StreamLib: Sub-range of another reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef ReaderSlc_h
+#define ReaderSlc_h
+
+/* ISO library header files */
+#include <stdbool.h>
+
+/* Local header files */
+#include "Reader.h"
+
+bool reader_slice_init(Reader * /*reader*/, Reader * /*parent*/,
+                       long int /*offset*/, long int /*length*/);
+/*
+ * creates an abstract reader object to allow 'length' bytes, starting at
+ * 'offset' bytes from the beginning of the input from another reader
+ * object, to be read as if they were an independent file. The new reader
+ * has its own file position, end-of-file and error indicators. Data is
+ * read from the parent without being copied to an intermediate buffer,
+ * and reader_fpeek is supported if the parent supports it. Each access
+ * seeks the parent, so several slices of the same parent can be used
+ * in turn, but the parent must be able to seek backward if the slice
+ * does. The parent must not be destroyed until after the slice.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* ReaderSlc_h */
@@ -0,0 +1,90 @@
+/*
+ * StreamLib: Spilling memory buffer reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added a peek function for data still in memory.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "ReaderSpl.h"
+
+static size_t reader_spill_fread(void *ptr, size_t const size,
+                                 Reader *const reader)
+{
+  assert(ptr != NULL);
+  assert(reader != NULL);
+  SpillBuf *const buf = reader->data;
+  assert(buf != NULL);
+  assert(reader->fpos >= 0);
+
+  long int const len = spillbuf_size(buf);
+  if (reader->fpos > len) {
+    DEBUGF("Can't seek beyond end at %ld\n", len);
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t const nread = spillbuf_read(buf, reader->fpos, ptr, size);
+  if (nread != size) {
+    /* A short read before the end of the data indicates a file error. */
+    if (reader->fpos + (long)nread < len) {
+      DEBUGF("set error\n");
+      reader->error = 1;
+    } else {
+      DEBUGF("set eof\n");
+      reader->eof = 1;
+    }
+  }
+  DEBUGF("Read %zu of %zu bytes\n", nread, size);
+
+  return nread;
+}
+
+static _Optional const void *reader_spill_peek(size_t *const size,
+                                               Reader *const reader)
+{
+  assert(size != NULL);
+  assert(reader != NULL);
+  SpillBuf *const buf = reader->data;
+  assert(buf != NULL);
+  assert(reader->fpos >= 0);
+
+  return spillbuf_peek(buf, reader->fpos, size);
+}
+
+static void reader_spill_destroy(Reader *const reader)
+{
+  NOT_USED(reader);
+}
+
+void reader_spill_init(Reader *const reader, SpillBuf *const buf)
+{
+  assert(reader != NULL);
+  assert(buf != NULL);
+
+  static ReaderFns const fns = {reader_spill_fread, reader_spill_destroy,
+                                reader_spill_peek};
+  reader_internal_init(reader, &fns, buf);
+}
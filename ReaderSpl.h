@@ -0,0 +1,45 @@
+/*
+ * StreamLib: Spilling memory buffer reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Data still in memory can be peeked.
+*/
+
+#ifndef ReaderSpl_h
+#define ReaderSpl_h
+
+/* Local header files */
+#include "SpillBuf.h"
+#include "Reader.h"
+
+void reader_spill_init(Reader * /*reader*/, SpillBuf * /*buf*/);
+/*
+ * creates an abstract reader object to allow the contents of a spilling
+ * buffer to be read as if they were stored in a file, regardless of
+ * whether they are in memory or a temporary file. The size of the
+ * input is the size of the stored data, which may change between reads
+ * if a writer object is also using the same buffer. Data that is still
+ * in memory can be peeked at without copying it.
+ */
+
+#endif /* ReaderSpl_h */
@@ -0,0 +1,289 @@
+/*
+ * StreamLib: Memory buffer which spills to a temporary file
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added spillbuf_peek.
+*/
+
+/* ISO library header files */
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "SpillBuf.h"
+
+enum {
+  MinBufferSize = 256,
+};
+
+struct SpillBuf {
+  size_t threshold;
+  long int len;
+  _Optional char *buffer; /* null once spilled */
+  size_t buffer_size;
+  _Optional FILE *file;   /* null until spilled */
+  long int file_pos;      /* current file position, or -1 if unknown */
+  bool writing;           /* whether the last file access was a write */
+};
+
+static bool spill(SpillBuf *const buf)
+{
+  assert(buf != NULL);
+  assert(buf->file == NULL);
+
+  DEBUGF("Spilling %ld bytes to a temporary file\n", buf->len);
+  _Optional FILE *const f = tmpfile();
+  if (f == NULL) {
+    DEBUGF("tmpfile failed: %s\n", strerror(errno));
+    return false;
+  }
+
+  if (buf->len > 0) {
+    assert(buf->buffer != NULL);
+    if (fwrite(&*buf->buffer, (size_t)buf->len, 1, &*f) != 1) {
+      DEBUGF("fwrite failed: %s\n", strerror(errno));
+      fclose(&*f);
+      return false;
+    }
+  }
+
+  free(buf->buffer);
+  buf->buffer = NULL;
+  buf->buffer_size = 0;
+  buf->file = f;
+  buf->file_pos = buf->len;
+  buf->writing = true;
+  return true;
+}
+
+static bool seek(SpillBuf *const buf, long int const pos, bool const writing)
+{
+  assert(buf != NULL);
+  assert(buf->file != NULL);
+
+  /* The C standard requires a file positioning function call between
+     output and input, so only skip redundant calls between accesses of
+     the same kind. */
+  if (buf->file_pos == pos && buf->writing == writing) {
+    return true;
+  }
+
+  if (fseek(&*buf->file, pos, SEEK_SET)) {
+    DEBUGF("fseek failed: %s\n", strerror(errno));
+    buf->file_pos = -1;
+    return false;
+  }
+
+  buf->file_pos = pos;
+  buf->writing = writing;
+  return true;
+}
+
+static bool ensure_buffer(SpillBuf *const buf, size_t const min_size)
+{
+  assert(buf != NULL);
+  assert(min_size <= buf->threshold);
+
+  if (min_size <= buf->buffer_size) {
+    return true;
+  }
+
+  /* Double the buffer size to reduce the number of reallocations, but
+     don't waste memory by exceeding the threshold. */
+  size_t new_size = buf->buffer_size;
+  if (new_size < MinBufferSize) {
+    new_size = MinBufferSize;
+  }
+  while (new_size < min_size && new_size <= SIZE_MAX / 2) {
+    new_size *= 2;
+  }
+  if (new_size < min_size || new_size > buf->threshold) {
+    new_size = buf->threshold;
+  }
+
+  _Optional char *const new_buffer = realloc(buf->buffer, new_size);
+  if (new_buffer == NULL) {
+    DEBUGF("Failed to extend buffer to %zu bytes\n", new_size);
+    return false;
+  }
+
+  DEBUG_VERBOSEF("Extended buffer from %zu to %zu bytes\n",
+                 buf->buffer_size, new_size);
+  buf->buffer = new_buffer;
+  buf->buffer_size = new_size;
+  return true;
+}
+
+_Optional SpillBuf *spillbuf_make(size_t const threshold)
+{
+  _Optional SpillBuf *const buf = malloc(sizeof(*buf));
+  if (buf == NULL) {
+    DEBUGF("Failed to allocate spill buffer\n");
+    return NULL;
+  }
+
+  *buf = (SpillBuf){
+    .threshold = threshold,
+    .len = 0,
+    .buffer = NULL,
+    .buffer_size = 0,
+    .file = NULL,
+    .file_pos = 0,
+    .writing = false,
+  };
+
+  return buf;
+}
+
+void spillbuf_destroy(_Optional SpillBuf *const buf)
+{
+  if (buf != NULL) {
+    if (buf->file && fclose(&*buf->file)) {
+      DEBUGF("fclose failed: %s\n", strerror(errno));
+    }
+    free(buf->buffer);
+    free(buf);
+  }
+}
+
+long int spillbuf_size(SpillBuf const *const buf)
+{
+  assert(buf != NULL);
+  return buf->len;
+}
+
+bool spillbuf_spilled(SpillBuf const *const buf)
+{
+  assert(buf != NULL);
+  return buf->file != NULL;
+}
+
+size_t spillbuf_read(SpillBuf *const buf, long int const pos,
+                     void *const ptr, size_t const size)
+{
+  assert(buf != NULL);
+  assert(pos >= 0);
+  assert(ptr != NULL);
+
+  if (pos >= buf->len) {
+    return 0;
+  }
+
+  size_t nread = size;
+  if ((unsigned long)(buf->len - pos) < nread) {
+    nread = (size_t)(buf->len - pos);
+  }
+
+  if (buf->file == NULL) {
+    assert(buf->buffer != NULL);
+    memcpy(ptr, &*buf->buffer + pos, nread);
+    return nread;
+  }
+
+  if (!seek(buf, pos, false)) {
+    return 0;
+  }
+
+  nread = fread(ptr, 1, nread, &*buf->file);
+  buf->file_pos += (long)nread;
+  return nread;
+}
+
+_Optional const void *spillbuf_peek(SpillBuf const *const buf,
+                                    long int const pos, size_t *const size)
+{
+  assert(buf != NULL);
+  assert(pos >= 0);
+  assert(size != NULL);
+
+  if (buf->file != NULL || pos >= buf->len) {
+    return NULL;
+  }
+
+  assert(buf->buffer != NULL);
+  *size = (size_t)(buf->len - pos);
+  return &*buf->buffer + pos;
+}
+
+size_t spillbuf_write(SpillBuf *const buf, long int const pos,
+                      void const *const ptr, size_t const size)
+{
+  assert(buf != NULL);
+  assert(pos >= 0);
+  assert(ptr != NULL);
+
+  if (size > (unsigned long)LONG_MAX - (unsigned long)pos) {
+    DEBUGF("Write of %zu bytes at offset %ld is too big\n", size, pos);
+    return 0;
+  }
+
+  unsigned long const end = (unsigned long)pos + size;
+  if (end == 0) {
+    return size;
+  }
+
+  if (buf->file == NULL) {
+    if (end <= buf->threshold) {
+      if (!ensure_buffer(buf, end)) {
+        return 0;
+      }
+      assert(buf->buffer != NULL);
+
+      if (pos > buf->len) {
+        /* To simulate a sparse file, zero-initialize skipped bytes. */
+        DEBUGF("Zeroing %ld bytes at offset %ld\n", pos - buf->len, buf->len);
+        memset(&*buf->buffer + buf->len, 0, (size_t)(pos - buf->len));
+      }
+      memcpy(&*buf->buffer + pos, ptr, size);
+
+      if (end > (unsigned long)buf->len) {
+        buf->len = (long)end;
+      }
+      return size;
+    }
+
+    if (!spill(buf)) {
+      return 0;
+    }
+  }
+
+  /* Seeking beyond the end of the file fills the gap with zeros. */
+  if (!seek(buf, pos, true)) {
+    return 0;
+  }
+
+  assert(buf->file != NULL);
+  size_t const nwritten = fwrite(ptr, 1, size, &*buf->file);
+  if (nwritten != size) {
+    DEBUGF("%zu of %zu bytes written: %s\n", nwritten, size, strerror(errno));
+  }
+  buf->file_pos += (long)nwritten;
+
+  if (buf->file_pos > buf->len) {
+    buf->len = buf->file_pos;
+  }
+  return nwritten;
+}
@@ -0,0 +1,105 @@
+/*
+ * StreamLib: Memory buffer which spills to a temporary file
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  Added spillbuf_peek.
+*/
+
+#ifndef SpillBuf_h
+#define SpillBuf_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
+typedef struct SpillBuf SpillBuf;
+
+_Optional SpillBuf *spillbuf_make(size_t /*threshold*/);
+/*
+ * creates an empty buffer which is stored in memory until its size would
+ * exceed 'threshold' bytes. At that point, its contents are moved to an
+ * anonymous temporary file (created by calling tmpfile) and all further
+ * data is stored in the file instead. This bounds the amount of memory
+ * used for unexpectedly large data without slowing down the common case.
+ * Returns: the address of the new object, or null if there was not
+ *          enough free memory.
+ */
+
+void spillbuf_destroy(_Optional SpillBuf * /*buf*/);
+/*
+ * destroys a spilling buffer, freeing its memory and closing (and thereby
+ * deleting) its temporary file, if any. Must not be called whilst any
+ * reader or writer objects are using it.
+ */
+
+long int spillbuf_size(SpillBuf const * /*buf*/);
+/*
+ * gets the number of bytes stored in a spilling buffer, which is one
+ * beyond the highest offset at which a byte has been written.
+ * Returns: the size of the stored data.
+ */
+
+bool spillbuf_spilled(SpillBuf const * /*buf*/);
+/*
+ * indicates whether or not the contents of a spilling buffer have been
+ * moved to a temporary file.
+ * Returns: true if the data is stored in a file, otherwise false.
+ */
+
+size_t spillbuf_read(SpillBuf * /*buf*/, long int /*pos*/,
+                     void * /*ptr*/, size_t /*size*/);
+/*
+ * copies up to 'size' bytes, starting at offset 'pos' within a spilling
+ * buffer, to the array pointed to by 'ptr'. Fewer bytes are copied if
+ * the end of the stored data is reached first or a file error occurs.
+ * Returns: the number of bytes copied.
+ */
+
+_Optional const void *spillbuf_peek(SpillBuf const * /*buf*/,
+                                    long int /*pos*/, size_t * /*size*/);
+/*
+ * gets the address of the data at offset 'pos' within a spilling buffer
+ * and stores the number of bytes that can be read from that address in
+ * the object pointed to by 'size', provided that the contents have not
+ * been moved to a temporary file. This allows small data to be read
+ * without copying it. The address remains valid until the next write.
+ * Returns: the address of the data, or null if the contents are stored
+ *          in a file or 'pos' is not before the end of the stored data.
+ */
+
+size_t spillbuf_write(SpillBuf * /*buf*/, long int /*pos*/,
+                      void const * /*ptr*/, size_t /*size*/);
+/*
+ * copies 'size' bytes from the array pointed to by 'ptr' to offset 'pos'
+ * within a spilling buffer, moving its contents to a temporary file if
+ * the threshold would otherwise be exceeded. If 'pos' is beyond the end
+ * of the stored data then the gap is filled with zeros.
+ * Returns: the number of bytes copied, which may be fewer than specified
+ *          if there was not enough free memory or a file error occurred.
+ */
+
+#endif /* SpillBuf_h */
@@ -0,0 +1,247 @@
+/*
+ * StreamLib: Copying from a reader to a writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  Read straight into the writer's storage if it supports
+                  writer_fprepare.
+                  Keep the reader's file position in range when copying
+                  between files.
+*/
+
+#ifdef __linux__
+/* Required for copy_file_range */
+#define _GNU_SOURCE
+#endif
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+/* Linux header files */
+#include <errno.h>
+#include <sys/sendfile.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define FILE_COPY
+#endif
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "StreamCopy.h"
+
+enum {
+  CopyBufferSize = 64 * 1024,
+  SmallBufferSize = 256, /* Used if a bigger buffer can't be allocated */
+  MaxFileCopySize = 1 << 30, /* Maximum size of one system call */
+};
+
+#ifdef FILE_COPY
+static long int copy_files(Reader *const reader, Writer *const writer,
+                           long int const length, bool *const at_end)
+{
+  assert(reader != NULL);
+  assert(writer != NULL);
+  assert(at_end != NULL);
+
+  _Optional FILE *const in = reader_raw_file(reader);
+  _Optional FILE *const out = writer_raw_file(writer);
+  if (in == NULL || out == NULL || reader->pushed_back != EOF ||
+      reader->eof || reader->error || writer->error) {
+    return 0;
+  }
+
+  /* Data buffered by the output stream must be written first. Any errors
+     are left to be reported by the slow path. */
+  if (fflush(&*out)) {
+    DEBUGF("fflush failed\n");
+    return 0;
+  }
+
+  /* The file positions are used as offsets from the start of the files,
+     as when seeking. */
+  if ((!reader->repos && ftell(&*in) != reader->fpos) ||
+      (!writer->repos && ftell(&*out) != writer->fpos)) {
+    DEBUGF("File positions are inconsistent\n");
+    return 0;
+  }
+
+  int const in_fd = fileno(&*in), out_fd = fileno(&*out);
+  off_t off_in = reader->fpos, off_out = writer->fpos;
+  bool use_sendfile = false;
+  long int done = 0;
+
+  /* Neither file position may overflow */
+  long int const max_pos = reader->fpos > writer->fpos ? reader->fpos :
+                                                         writer->fpos;
+
+  while (length < 0 || done < length) {
+    long int n = length < 0 ? LONG_MAX - done : length - done;
+    if (LONG_MAX - max_pos - done < n) {
+      n = LONG_MAX - max_pos - done;
+    }
+    if (n > MaxFileCopySize) {
+      n = MaxFileCopySize;
+    }
+    if (n == 0) {
+      break;
+    }
+
+    ssize_t copied;
+    if (!use_sendfile) {
+      copied = copy_file_range(in_fd, &off_in, out_fd, &off_out, (size_t)n,
+                               0);
+      if (copied < 0 && (errno == ENOSYS || errno == EXDEV ||
+                         errno == EINVAL || errno == EOPNOTSUPP)) {
+        /* Unsupported between these files, so try the older call, which
+           writes at the current offset of the output file. */
+        DEBUGF("copy_file_range failed; trying sendfile\n");
+        if (lseek(out_fd, off_out, SEEK_SET) < 0) {
+          break;
+        }
+        use_sendfile = true;
+        continue;
+      }
+    } else {
+      copied = sendfile(out_fd, in_fd, &off_in, (size_t)n);
+      if (copied > 0) {
+        off_out += copied;
+      }
+    }
+
+    if (copied < 0) {
+      /* Leave it to the slow path to continue (or report an error) */
+      DEBUGF("Fast file copy failed after %ld bytes\n", done);
+      break;
+    }
+
+    if (copied == 0) {
+      DEBUGF("End of input file after %ld bytes\n", done);
+      *at_end = true;
+      reader->eof = 1;
+      break;
+    }
+
+    done += (long)copied;
+  }
+
+  if (done > 0 || *at_end) {
+    /* The stdio streams' positions are stale, so force them to seek */
+    reader->fpos += done;
+    reader->repos = 1;
+    writer->fpos += done;
+    writer->repos = 1;
+    if (writer->fpos > writer->flen) {
+      writer->flen = writer->fpos;
+    }
+  }
+
+  DEBUGF("Copied %ld bytes between files\n", done);
+  return done;
+}
+#endif /* FILE_COPY */
+
+long int stream_copy(Reader *const reader, Writer *const writer,
+                     long int const length)
+{
+  assert(reader != NULL);
+  assert(writer != NULL);
+
+  long int done = 0;
+  bool at_end = false;
+
+#ifdef FILE_COPY
+  done = copy_files(reader, writer, length, &at_end);
+#endif
+
+  _Optional char *big_buf = NULL;
+  char small_buf[SmallBufferSize];
+  char *buf = NULL;
+  size_t buf_size = 0;
+
+  while (!at_end && (length < 0 || done < length) &&
+         !reader_ferror(reader) && !writer_ferror(writer)) {
+    long int const remaining = length < 0 ? LONG_MAX - done : length - done;
+
+    /* Write directly from the reader's memory if possible */
+    size_t n;
+    _Optional const void *const src = reader_fpeek(reader, &n);
+    if (src != NULL) {
+      if ((unsigned long)remaining < n) {
+        n = (size_t)remaining;
+      }
+
+      size_t const nwritten = writer_fwrite((const void *)src, 1, n, writer);
+      if (reader_fseek(reader, (long)nwritten, SEEK_CUR)) {
+        break;
+      }
+      done += (long)nwritten;
+      continue;
+    }
+
+    /* Read directly into the writer's storage if possible */
+    size_t const min_size = (unsigned long)remaining < CopyBufferSize ?
+                            (size_t)remaining : CopyBufferSize;
+    _Optional void *const dst = writer_fprepare(writer, min_size, &n);
+    if (dst != NULL) {
+      if ((unsigned long)remaining < n) {
+        n = (size_t)remaining;
+      }
+
+      size_t const nread = reader_fread((void *)dst, 1, n, reader);
+      writer_fcommit(writer, nread);
+      done += (long)nread;
+      if (nread != n) {
+        at_end = true;
+      }
+      continue;
+    }
+
+    if (buf == NULL) {
+      big_buf = malloc(CopyBufferSize);
+      if (big_buf != NULL) {
+        buf = &*big_buf;
+        buf_size = CopyBufferSize;
+      } else {
+        DEBUGF("Falling back to a small buffer\n");
+        buf = small_buf;
+        buf_size = sizeof(small_buf);
+      }
+    }
+
+    n = buf_size;
+    if ((unsigned long)remaining < n) {
+      n = (size_t)remaining;
+    }
+
+    size_t const nread = reader_fread(buf, 1, n, reader);
+    done += (long)writer_fwrite(buf, 1, nread, writer);
+    if (nread != n) {
+      at_end = true;
+    }
+  }
+
+  free(big_buf);
+  DEBUGF("Copied %ld bytes\n", done);
+  return done;
+}
@@ -0,0 +1,54 @@
+/*
+ * StreamLib: Copying from a reader to a writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef StreamCopy_h
+#define StreamCopy_h
+
+/* Local header files */
+#include "Reader.h"
+#include "Writer.h"
+
+long int stream_copy(Reader * /*reader*/, Writer * /*writer*/,
+                     long int /*length*/);
+/*
+ * copies up to 'length' bytes (or all of the remaining input, if
+ * 'length' is negative) from the current position of the reader object
+ * pointed to by 'reader' to the current position of the writer object
+ * pointed to by 'writer'. Both file position indicators are advanced by
+ * the number of bytes copied, unless a write error occurred, in which
+ * case the reader's position may be beyond the last byte written.
+ * If the reader supports reader_fpeek then its data is written directly,
+ * otherwise if the writer supports writer_fprepare then data is read
+ * directly into the writer's storage.
+ * On Linux, files read and written by reader_raw_init and writer_raw_init
+ * are copied by the kernel without passing through user memory. Otherwise
+ * a large internal buffer is used. Copying stops early if the end of the
+ * input is reached or an error occurs, in which case the end-of-file or
+ * error indicators of the reader or writer are set, as appropriate.
+ * Returns: the number of bytes copied.
+ */
+
+#endif /* StreamCopy_h */
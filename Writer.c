@@ -29,6 +29,7 @@
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
   CJB: 21-May-26: Explicitly convert the return value of fwrite_fn
                   to long int to silence a compiler warning.
+  CJB: 18-Oct-26: Allow a short count from a non-blocking writer.
 */
 
 /* ISO library header files */
@@ -85,7 +86,8 @@ size_t writer_fwrite(void const *const ptr, size_t const size,
           nwritten = size == 1 ? n : n / size;
         }
         DEBUG_VERBOSEF("Wrote %zu members of size %zu\n", nwritten, size);
-        assert(nwritten == nmemb || writer->error);
+        /* A non-blocking writer may write less without setting the
+           error indicator, if it has no more room yet. */
       }
     }
   }
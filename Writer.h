@@ -27,6 +27,8 @@ History:
   CJB: 10-Jul-20: Added signed 16-bit and unsigned 32-bit write functions.
   CJB: 28-Jul-22: Removed redundant use of the 'extern' keyword.
   CJB: 20-May-26: Use bool type for bitfields.
+  CJB: 18-Oct-26: Added an optional prepare function for zero-copy writes.
+                  A non-blocking writer may return a short count.
 */
 
 #ifndef Writer_h
@@ -38,6 +40,10 @@ History:
 #include <stdint.h>
 #include <stdio.h>
 
+#if !defined(USE_OPTIONAL) && !defined(_Optional)
+#define _Optional
+#endif
+
 struct Writer;
 
 typedef size_t WriterWriteFn(void const *ptr, size_t size,
@@ -60,9 +66,25 @@ typedef bool WriterTermFn(struct Writer *writer);
  * Returns: true if successful, otherwise false.
  */
 
+typedef _Optional void *WriterPrepareFn(size_t min_size, size_t *size,
+                                        struct Writer *writer);
+/*
+ * gets the address of storage for data at the current file position of a
+ * given abstract writer object, making room for at least 'min_size' bytes
+ * if necessary, and stores the number of bytes that can be written
+ * contiguously at that address in the object pointed to by 'size'. Any
+ * gap between the end of the data and the file position must be filled
+ * with zeros. The storage must remain valid until the next call to a
+ * function that operates on the same writer. This function must not set
+ * the error indicator or change the file position or size.
+ * Returns: the address of the storage, or null if none can be accessed
+ *          directly.
+ */
+
 typedef struct {
   WriterWriteFn *fwrite_fn;
   WriterTermFn *term_fn;
+  _Optional WriterPrepareFn *prepare_fn; /* may be null */
 } WriterFns;
 
 typedef struct Writer {
@@ -102,6 +124,31 @@ int writer_fseek(Writer * /*writer*/, long int /*offset*/, int /*whence*/);
  * Returns: 0 if successful or non-zero if the request is invalid.
  */
 
+_Optional void *writer_fprepare(Writer * /*writer*/, size_t /*min_size*/,
+                                size_t * /*size*/);
+/*
+ * gets the address of storage for data at the current file position of a
+ * given abstract writer object, if data can be stored there without
+ * copying it, and stores the number of bytes that can be written
+ * contiguously at that address in the object pointed to by 'size'. Room
+ * is made for at least 'min_size' bytes if the writer can grow its
+ * storage. Nothing is written until writer_fcommit is called. The address
+ * remains valid until the next call to a function that operates on the
+ * same writer. Not all types of writer support this function, and it
+ * fails if the error indicator is set. Callers should then use
+ * writer_fwrite instead.
+ * Returns: the address of the storage, or null (storing 0 as the size) if
+ *          none can be accessed directly.
+ */
+
+void writer_fcommit(Writer * /*writer*/, size_t /*size*/);
+/*
+ * advances the file position indicator of an abstract writer object by
+ * 'size' bytes that were stored at the address returned by the preceding
+ * call to writer_fprepare, extending the output if necessary. The size
+ * must not exceed that stored by writer_fprepare.
+ */
+
 int writer_fputc(int /*c*/, Writer * /*writer*/);
 /*
  * writes the byte specified by c to the data store abstracted by a
@@ -118,7 +165,8 @@ size_t writer_fwrite(void const * /*ptr*/, size_t /*size*/, size_t /*nmemb*/,
  * in bytes, is specified by 'size'. The file position indicator is
  * advanced by the number of bytes successfully written. If fewer than the
  * requested number of members were written then this function sets the
- * error indicator.
+ * error indicator, unless the writer is non-blocking and has no more room
+ * yet (see writer_pipe_init).
  * Returns: the number of members successfully written, which may be fewer
  *          than specified if a write error occurred.
  */
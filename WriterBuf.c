@@ -0,0 +1,151 @@
+/*
+ * StreamLib: Buffered writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "WriterBuf.h"
+
+typedef struct {
+  Writer *out;
+  long int start; /* offset of the buffered data within the output */
+  size_t len, capacity;
+  char buffer[];
+} WriterBufData;
+
+static bool flush(Writer *const writer)
+{
+  assert(writer != NULL);
+  WriterBufData *const data = writer->data;
+  assert(data != NULL);
+
+  if (data->len == 0) {
+    return true;
+  }
+
+  DEBUG_VERBOSEF("Flushing %zu bytes at %ld\n", data->len, data->start);
+
+  /* The other writer may have been used by someone else, so always seek
+     (which is cheap unless the position actually changes). */
+  if (writer_fseek(data->out, data->start, SEEK_SET) ||
+      writer_fwrite(data->buffer, 1, data->len, data->out) != data->len) {
+    DEBUGF("Failed to flush %zu bytes at %ld\n", data->len, data->start);
+    writer->error = 1;
+    return false;
+  }
+
+  data->len = 0;
+  return true;
+}
+
+static size_t writer_buf_fwrite(void const *ptr, size_t const size,
+                                Writer *const writer)
+{
+  assert(ptr != NULL);
+  assert(writer != NULL);
+  WriterBufData *const data = writer->data;
+  assert(data != NULL);
+  assert(writer->fpos >= 0);
+
+  /* Writes which overlap or extend the buffered data are merged with it,
+     provided that the result is still contiguous and fits. */
+  long int const offset = writer->fpos - data->start;
+  if (data->len > 0 && offset >= 0 && offset <= (long)data->len &&
+      size <= data->capacity - (size_t)offset) {
+    memcpy(data->buffer + offset, ptr, size);
+    if ((size_t)offset + size > data->len) {
+      data->len = (size_t)offset + size;
+    }
+    return size;
+  }
+
+  if (!flush(writer)) {
+    return 0;
+  }
+
+  if (size >= data->capacity) {
+    /* Too big to buffer, so write directly from the caller's buffer */
+    if (writer_fseek(data->out, writer->fpos, SEEK_SET)) {
+      writer->error = 1;
+      return 0;
+    }
+    size_t const n = writer_fwrite(ptr, 1, size, data->out);
+    if (n != size) {
+      DEBUGF("%zu of %zu bytes written\n", n, size);
+      writer->error = 1;
+    }
+    return n;
+  }
+
+  data->start = writer->fpos;
+  data->len = size;
+  memcpy(data->buffer, ptr, size);
+  return size;
+}
+
+static bool writer_buf_destroy(Writer *const writer)
+{
+  assert(writer != NULL);
+
+  /* Don't write buffered data if the error indicator is set */
+  bool const ok = !writer->error && flush(writer);
+  free(writer->data);
+  return ok;
+}
+
+bool writer_buffered_init(Writer *const writer, Writer *const out,
+                          size_t const buffer_size)
+{
+  assert(writer != NULL);
+  assert(out != NULL);
+  assert(buffer_size > 0);
+
+  if (buffer_size > SIZE_MAX - sizeof(WriterBufData)) {
+    DEBUGF("Buffer size %zu is too big\n", buffer_size);
+    return false;
+  }
+
+  _Optional WriterBufData *const data =
+    malloc(sizeof(*data) + buffer_size);
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new writer\n");
+    return false;
+  }
+
+  data->out = out;
+  data->start = 0;
+  data->len = 0;
+  data->capacity = buffer_size;
+
+  static WriterFns const fns = {writer_buf_fwrite, writer_buf_destroy, NULL};
+  writer_internal_init(writer, &fns, &*data);
+
+  return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * StreamLib: Buffered writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef WriterBuf_h
+#define WriterBuf_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local header files */
+#include "Writer.h"
+
+bool writer_buffered_init(Writer * /*writer*/, Writer * /*out*/,
+                          size_t /*buffer_size*/);
+/*
+ * creates an abstract writer object to allow data to be collected in a
+ * buffer of 'buffer_size' bytes before being written to the writer object
+ * pointed to by 'out'. Small writes (such as by writer_fputc) don't use
+ * the other writer, and nor do seeks within the buffered data. Writes at
+ * least as big as the buffer bypass it. Buffered data is written when
+ * a write can't be merged with it, or when this writer is destroyed.
+ * The other writer is not destroyed with this one, and must not be
+ * destroyed until after it.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* WriterBuf_h */
@@ -0,0 +1,63 @@
+/*
+ * StreamLib: Segmented memory buffer writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "WriterChnk.h"
+
+static size_t writer_chunks_fwrite(void const *ptr, size_t const size,
+                                   Writer *const writer)
+{
+  assert(ptr != NULL);
+  assert(writer != NULL);
+  Chunks *const chunks = writer->data;
+  assert(chunks != NULL);
+  assert(writer->fpos >= 0);
+
+  size_t const nwritten = chunks_write(chunks, writer->fpos, ptr, size);
+  if (nwritten != size) {
+    DEBUGF("%zu of %zu bytes written\n", nwritten, size);
+    writer->error = 1;
+  }
+  return nwritten;
+}
+
+static bool writer_chunks_destroy(Writer *const writer)
+{
+  NOT_USED(writer);
+  return true;
+}
+
+void writer_chunks_init(Writer *const writer, Chunks *const chunks)
+{
+  assert(writer != NULL);
+  assert(chunks != NULL);
+
+  static WriterFns const fns = {writer_chunks_fwrite, writer_chunks_destroy,
+                                NULL};
+  writer_internal_init(writer, &fns, chunks);
+}
@@ -0,0 +1,43 @@
+/*
+ * StreamLib: Segmented memory buffer writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef WriterChnk_h
+#define WriterChnk_h
+
+/* Local header files */
+#include "Chunks.h"
+#include "Writer.h"
+
+void writer_chunks_init(Writer * /*writer*/, Chunks * /*chunks*/);
+/*
+ * creates an abstract writer object to allow data to be stored in a
+ * segmented buffer as if it were stored in a file. New chunks are
+ * appended to the buffer as necessary, so the data already written is
+ * never moved or copied. Writing starts at the beginning of the buffer,
+ * overwriting any data already stored there.
+ */
+
+#endif /* WriterChnk_h */
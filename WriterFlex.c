@@ -155,6 +155,6 @@ void writer_flex_init(Writer *const writer, flex_ptr const anchor)
   assert(writer != NULL);
   assert(anchor != NULL);
 
-  static WriterFns const fns = {writer_flex_fwrite, writer_flex_destroy};
+  static WriterFns const fns = {writer_flex_fwrite, writer_flex_destroy, NULL};
   writer_internal_init(writer, &fns, anchor);
 }
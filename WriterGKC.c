@@ -263,7 +263,7 @@ bool writer_gkc_init_with_min(Writer *const writer,
   }
   data->state.comp = &*comp;
 
-  static WriterFns const fns = {writer_gkc_fwrite, writer_gkc_destroy};
+  static WriterFns const fns = {writer_gkc_fwrite, writer_gkc_destroy, NULL};
   writer_internal_init(writer, &fns, &*data);
 
   prepare_for_input(&*data);
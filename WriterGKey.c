@@ -41,6 +41,14 @@
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
   CJB: 29-Apr-26: Stop dereferencing a pointer of type void *.
   CJB: 21-May-26: Refactored write_core to use long int for byte counts.
+  CJB: 18-Oct-26: Added writer_gkey_reinit and writer_gkey_reinit_from.
+                  The raw backend is now embedded in the writer's data.
+                  Compressed data is stored straight into the backend's
+                  storage if it supports writer_fprepare.
+                  Added writer_gkey_set_exact and writer_gkey_set_spool.
+                  Added writer_gkey_set_extended.
+                  Added writer_gkey_set_members, writer_gkey_append and
+                  writer_gkey_append_from.
 */
 
 /* ISO library header files */
@@ -57,7 +65,9 @@
 #include "GKeyComp.h"
 
 /* Local headers */
+#include "Internal/GKeyHdr.h"
 #include "Internal/StreamMisc.h"
+#include "SpillBuf.h"
 #include "WriterGKey.h"
 #include "WriterRaw.h"
 
@@ -68,14 +78,29 @@ enum {
 typedef struct {
   bool wrote_hdr, owns_backend;
   char *in_ptr; /* remaining space within in_buffer */
+  _Optional char *out_start; /* backend's storage, if used for output */
   long int min_size;
+  long int hdr_pos;  /* offset of the header in the backend */
+  long int comp_len; /* no. of compressed bytes output after the header */
   GKeyComp *comp;
   GKeyParameters params;
   Writer *backend;
 } WriterGKeyState;
 
+typedef struct {
+  _Optional SpillBuf *buf;
+  long int limit; /* maximum no. of compressed bytes to spool */
+  long int len;   /* no. of bytes spooled, excluding the header */
+  bool overflow;  /* whether the spooled data was written to the backend */
+} WriterGKeySpool;
+
 typedef struct {
   WriterGKeyState state;
+  WriterGKeySpool spool; /* settings survive reinitialization */
+  bool exact;            /* whether min_size is also the maximum size */
+  bool extended;         /* whether to write a header with a 64-bit size */
+  bool members;          /* whether to write a member header */
+  Writer raw; /* backend used if owns_backend */
   struct {
     char in[BUFFER_SIZE];
     char out[BUFFER_SIZE];
@@ -89,18 +114,100 @@ static void prepare_for_input(WriterGKeyData *const data)
   data->state.params.in_buffer = data->buffer.in;
 }
 
+static bool hdr_final(WriterGKeyData const *const data)
+{
+  assert(data != NULL);
+
+  /* A member header also stores the compressed size, which isn't known
+     until all of the data has been written. */
+  return data->exact && !data->members;
+}
+
+static bool spooling(WriterGKeyData const *const data)
+{
+  assert(data != NULL);
+  return data->spool.buf != NULL && !data->spool.overflow &&
+         !hdr_final(data);
+}
+
 static void prepare_for_output(WriterGKeyData *const data)
 {
   assert(data != NULL);
+
+  /* Once the header has been written, compress straight into the
+     backend's storage if possible. */
+  if (data->state.wrote_hdr && !spooling(data)) {
+    size_t size;
+    _Optional void *const ptr =
+      writer_fprepare(data->state.backend, BUFFER_SIZE, &size);
+
+    if (ptr != NULL) {
+      DEBUG_VERBOSEF("Output to %zu bytes of backend storage\n", size);
+      data->state.out_start = (char *)ptr;
+      data->state.params.out_buffer = (void *)ptr;
+      data->state.params.out_size = size;
+      return;
+    }
+  }
+
+  data->state.out_start = NULL;
   data->state.params.out_buffer = data->buffer.out;
   data->state.params.out_size = sizeof(data->buffer.out);
 }
 
+static size_t out_used(WriterGKeyData const *const data)
+{
+  assert(data != NULL);
+  const char *const start = data->state.out_start ?
+                            &*data->state.out_start : data->buffer.out;
+
+  assert((const char *)data->state.params.out_buffer >= start);
+  return (size_t)((const char *)data->state.params.out_buffer - start);
+}
+
+static bool write_uint64(uint64_t const val, Writer *const writer)
+{
+  assert(writer != NULL);
+  return writer_fwrite_uint32((uint32_t)val, writer) &&
+         writer_fwrite_uint32((uint32_t)(val >> 32), writer);
+}
+
 static bool write_hdr(WriterGKeyData *const data, long int const len)
 {
   assert(data != NULL);
   assert(len >= 0);
 
+  data->state.hdr_pos = writer_ftell(data->state.backend);
+
+  if (data->members) {
+    assert(data->state.comp_len >= 0);
+    if (!writer_fwrite_int32(GKeyHdr_Marker, data->state.backend) ||
+        !writer_fwrite_uint32(GKeyHdr_Version | GKeyHdr_Member,
+                              data->state.backend) ||
+        !write_uint64((uint64_t)len, data->state.backend) ||
+        !write_uint64((uint64_t)data->state.comp_len,
+                      data->state.backend)) {
+      DEBUGF("Failed to write member header\n");
+      return false;
+    }
+
+    DEBUGF("Wrote uncompressed size %ld and compressed size %ld at %ld\n",
+           len, data->state.comp_len, data->state.hdr_pos);
+    return true;
+  }
+
+  if (data->extended) {
+    if (!writer_fwrite_int32(GKeyHdr_Marker, data->state.backend) ||
+        !writer_fwrite_uint32(GKeyHdr_Version, data->state.backend) ||
+        !write_uint64((uint64_t)len, data->state.backend)) {
+      DEBUGF("Failed to write extended header\n");
+      return false;
+    }
+
+    DEBUGF("Wrote uncompressed size %ld in extended header\n", len);
+    return true;
+  }
+
   if (len > INT32_MAX) {
     DEBUGF("Bad uncompressed size %ld\n", len);
     return false;
@@ -115,34 +222,100 @@ static bool write_hdr(WriterGKeyData *const data, long int const len)
   return true;
 }
 
-static bool empty_out(WriterGKeyData *const data)
+static bool unspool(WriterGKeyData *const data, long int const len)
+{
+  assert(data != NULL);
+  WriterGKeySpool *const spool = &data->spool;
+  assert(spooling(data));
+  assert(spool->buf != NULL);
+
+  /* Any further compressed data goes straight to the backend */
+  spool->overflow = true;
+
+  if (!write_hdr(data, len)) {
+    return false;
+  }
+
+  DEBUGF("Writing %ld bytes of spooled compressed data\n", spool->len);
+  for (long int pos = 0; pos < spool->len;) {
+    char tmp[BUFFER_SIZE];
+    long int const avail = spool->len - pos;
+    size_t const n = avail > (long)sizeof(tmp) ? sizeof(tmp) : (size_t)avail;
+
+    if (spillbuf_read(&*spool->buf, pos, tmp, n) != n ||
+        writer_fwrite(tmp, 1, n, data->state.backend) != n) {
+      DEBUGF("Failed to write spooled compressed data\n");
+      return false;
+    }
+    pos += (long)n;
+  }
+  return true;
+}
+
+static bool spool_out(WriterGKeyData *const data, size_t const n)
+{
+  assert(data != NULL);
+  WriterGKeySpool *const spool = &data->spool;
+  assert(spooling(data));
+  assert(spool->buf != NULL);
+
+  if ((unsigned long)(spool->limit - spool->len) < n ||
+      spillbuf_write(&*spool->buf, spool->len, data->buffer.out, n) != n) {
+    /* Too big to spool, so the header may need to be rewritten later */
+    DEBUGF("Stopped spooling compressed data at %ld\n", spool->len);
+    return false;
+  }
+
+  spool->len += (long)n;
+  DEBUGF("Spooled %zu bytes of compressed data\n", n);
+  return true;
+}
+
+static bool empty_out(WriterGKeyData *const data, bool const more)
 {
   assert(data != NULL);
 
-  /* Write size of compressed data if we didn't already */
+  /* Write size of compressed data if we didn't already. If spooling then
+     the header is written when the true size is known. */
   if (!data->state.wrote_hdr) {
     data->state.wrote_hdr = true;
-    if (!write_hdr(data, data->state.min_size)) {
+    if (!spooling(data) && !write_hdr(data, data->state.min_size)) {
       return false;
     }
   }
 
-  assert((const char *)data->state.params.out_buffer >= data->buffer.out);
-  assert(data->state.params.out_size <= sizeof(data->buffer.out));
-  size_t const used_size =
-    sizeof(data->buffer.out) - data->state.params.out_size;
+  size_t const used_size = out_used(data);
 
-  /* Empty the output buffer by writing to file */
-  size_t const n =
-    writer_fwrite(data->buffer.out, 1, used_size, data->state.backend);
-  DEBUGF("Emptied %zu bytes of compressed data from output buffer\n", n);
-
-  if (n != used_size) {
-    DEBUGF("Failed to write compressed data to file\n");
+  if (spooling(data) && !spool_out(data, used_size) &&
+      !unspool(data, data->state.min_size)) {
     return false;
   }
 
-  prepare_for_output(data);
+  if (spooling(data)) {
+    /* The data was spooled */
+  } else if (data->state.out_start) {
+    /* The data is already in place */
+    writer_fcommit(data->state.backend, used_size);
+    DEBUGF("Committed %zu bytes of compressed data\n", used_size);
+  } else {
+    /* Empty the output buffer by writing to file */
+    assert(data->state.params.out_size <= sizeof(data->buffer.out));
+    size_t const n =
+      writer_fwrite(data->buffer.out, 1, used_size, data->state.backend);
+    DEBUGF("Emptied %zu bytes of compressed data from output buffer\n", n);
+
+    if (n != used_size) {
+      DEBUGF("Failed to write compressed data to file\n");
+      return false;
+    }
+  }
+
+  assert(used_size <= (unsigned long)(LONG_MAX - data->state.comp_len));
+  data->state.comp_len += (long)used_size;
+
+  if (more) {
+    prepare_for_output(data);
+  }
   return true;
 }
 
@@ -161,9 +334,9 @@ static bool empty_in(WriterGKeyData *const data)
 
     assert(status == GKeyStatus_OK || status == GKeyStatus_BufferOverflow);
     DEBUGF("Filled output buffer with %zu bytes of compressed data\n",
-           sizeof(data->buffer.out) - data->state.params.out_size);
+           out_used(data));
 
-    if (status == GKeyStatus_BufferOverflow && !empty_out(data)) {
+    if (status == GKeyStatus_BufferOverflow && !empty_out(data, true)) {
       return false;
     }
   }
@@ -191,9 +364,9 @@ static bool flush(WriterGKeyData *const data)
            status == GKeyStatus_Finished);
 
     DEBUGF("Filled output buffer with %zu bytes of compressed data\n",
-           sizeof(data->buffer.out) - data->state.params.out_size);
+           out_used(data));
 
-    if (!empty_out(data)) {
+    if (!empty_out(data, status != GKeyStatus_Finished)) {
       return false;
     }
   } while (status != GKeyStatus_Finished);
@@ -278,15 +451,31 @@ static bool cleanup(Writer *const writer)
     return false;
   }
 
-  if (flen > min_size) {
-    /* Try to rewind the output file to correct the input data size. */
-    if (writer_fseek(data->state.backend, 0, SEEK_SET)) {
-      DEBUGF("Failed to seek start of file to increase size\n");
+  if (spooling(data)) {
+    /* Now that the true input data size is known, write it before the
+       spooled output. */
+    if (!unspool(data, flen > min_size ? flen : min_size)) {
+      return false;
+    }
+  } else if (flen > min_size || data->members) {
+    /* Try to rewind the output file to correct the input data size
+       (and the compressed data size, if writing a member). */
+    long int const end = writer_ftell(data->state.backend);
+    if (writer_fseek(data->state.backend, data->state.hdr_pos, SEEK_SET)) {
+      DEBUGF("Failed to seek header at %ld to correct it\n",
+             data->state.hdr_pos);
       return false;
     }
 
-    /* Store the true uncompressed size at the start of the output. */
-    if (!write_hdr(data, flen)) {
+    /* Store the true size(s) at the start of the output. */
+    if (!write_hdr(data, flen > min_size ? flen : min_size)) {
+      return false;
+    }
+
+    /* Leave the output positioned after the compressed data, so that
+       another member can be appended. */
+    if (writer_fseek(data->state.backend, end, SEEK_SET)) {
+      DEBUGF("Failed to seek end of compressed data at %ld\n", end);
       return false;
     }
   }
@@ -301,8 +490,25 @@ static size_t writer_gkey_fwrite(void const *const ptr,
 {
   assert(ptr != NULL);
   assert(writer != NULL);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
   assert(writer->fpos >= 0);
 
+  /* If the size was declared up front then don't write beyond it,
+     because the header can't be corrected afterwards. */
+  size_t n = bytes_to_write;
+  long int const max_size = data->state.min_size;
+  if (data->exact &&
+      (writer->fpos > max_size ||
+       (unsigned long)(max_size - writer->fpos) < bytes_to_write)) {
+    DEBUGF("Can't write beyond the declared size %ld\n", max_size);
+    writer->error = 1;
+    if (writer->fpos >= max_size) {
+      return 0;
+    }
+    n = (size_t)(max_size - writer->fpos);
+  }
+
   /* If fseek was used since the last write then find the right position
      at which to start writing. */
   if (writer->fpos != writer->flen) {
@@ -326,13 +532,13 @@ static size_t writer_gkey_fwrite(void const *const ptr,
     }
   }
 
-  assert(bytes_to_write <= LONG_MAX);
-  long int const nwritten = write_core(ptr, (long)bytes_to_write, writer);
-  assert((unsigned long)nwritten <= bytes_to_write);
+  assert(n <= LONG_MAX);
+  long int const nwritten = write_core(ptr, (long)n, writer);
+  assert((unsigned long)nwritten <= n);
   return (size_t)nwritten;
 }
 
-static bool writer_gkey_destroy(Writer *const writer)
+static bool finish(Writer *const writer)
 {
   assert(writer != NULL);
   WriterGKeyData *const data = writer->data;
@@ -345,38 +551,46 @@ static bool writer_gkey_destroy(Writer *const writer)
     success = false;
   }
 
-  gkeycomp_destroy(data->state.comp);
-
-  if (data->state.owns_backend) {
-    if (writer_destroy(data->state.backend) < 0) {
-      success = false;
-    }
-    free(data->state.backend);
+  if (data->state.owns_backend && writer_destroy(data->state.backend) < 0) {
+    success = false;
   }
 
+  return success;
+}
+
+static bool writer_gkey_destroy(Writer *const writer)
+{
+  assert(writer != NULL);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+
+  bool const success = finish(writer);
+  gkeycomp_destroy(data->state.comp);
+  spillbuf_destroy(data->spool.buf);
   free(data);
   return success;
 }
 
-bool writer_gkey_init_from(Writer *const writer,
-                           unsigned int const history_log_2,
-                           long int const min_size, Writer *const out)
+static void attach(Writer *const writer, WriterGKeyData *const data,
+                   long int const min_size, Writer *const out,
+                   bool const owns_backend)
 {
   assert(writer != NULL);
+  assert(data != NULL);
+  assert(min_size >= 0);
   assert(out != NULL);
   assert(!writer_ferror(out));
 
-  _Optional WriterGKeyData *const data = malloc(sizeof(*data));
-  if (data == NULL) {
-    DEBUGF("Failed to allocate writer data\n");
-    return false;
-  }
+  GKeyComp *const comp = data->state.comp;
 
   data->state = (WriterGKeyState){
     .backend = out,
-    .owns_backend = false,
+    .owns_backend = owns_backend,
     .wrote_hdr = false,
     .min_size = min_size,
+    .hdr_pos = 0,
+    .comp_len = 0,
+    .comp = comp,
     .params =
       {
         .prog_cb = (GKeyProgressFn *)NULL,
@@ -384,20 +598,50 @@ bool writer_gkey_init_from(Writer *const writer,
       },
   };
 
+  static WriterFns const fns = {writer_gkey_fwrite, writer_gkey_destroy, NULL};
+  writer_internal_init(writer, &fns, data);
+
+  data->spool.len = 0;
+  data->spool.overflow = false;
+  prepare_for_input(data);
+  prepare_for_output(data);
+}
+
+static _Optional WriterGKeyData *make_data(unsigned int const history_log_2)
+{
+  _Optional WriterGKeyData *const data = malloc(sizeof(*data));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate writer data\n");
+    return NULL;
+  }
+
   _Optional GKeyComp *const comp = gkeycomp_make(history_log_2);
   if (comp == NULL) {
     DEBUGF("Failed to create compressor\n");
     free(data);
-    return false;
+    return NULL;
   }
   data->state.comp = &*comp;
+  data->spool = (WriterGKeySpool){.buf = NULL, .limit = 0};
+  data->exact = false;
+  data->extended = false;
+  data->members = false;
+  return data;
+}
 
-  static WriterFns const fns = {writer_gkey_fwrite, writer_gkey_destroy};
-  writer_internal_init(writer, &fns, &*data);
+bool writer_gkey_init_from(Writer *const writer,
+                           unsigned int const history_log_2,
+                           long int const min_size, Writer *const out)
+{
+  assert(writer != NULL);
+  assert(out != NULL);
 
-  prepare_for_input(&*data);
-  prepare_for_output(&*data);
+  _Optional WriterGKeyData *const data = make_data(history_log_2);
+  if (data == NULL) {
+    return false;
+  }
 
+  attach(writer, &*data, min_size, out, false);
   return true;
 }
 
@@ -405,29 +649,162 @@ bool writer_gkey_init(Writer *const writer, unsigned int const history_log_2,
                       long int const min_size, FILE *const out)
 {
   assert(writer != NULL);
-  assert(min_size >= 0);
   assert(out != NULL);
   assert(!ferror(out));
 
-  _Optional Writer *const raw = malloc(sizeof(*raw));
-  if (raw == NULL) {
-    DEBUGF("Failed to allocate raw backend\n");
+  _Optional WriterGKeyData *const data = make_data(history_log_2);
+  if (data == NULL) {
+    DEBUGF("Failed to initialize a new writer\n");
+    return false;
+  }
+
+  writer_raw_init(&data->raw, out);
+  attach(writer, &*data, min_size, &data->raw, true);
+  return true;
+}
+
+long int writer_gkey_reinit_from(Writer *const writer,
+                                 long int const min_size, Writer *const out)
+{
+  assert(writer != NULL);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+  assert(out != NULL);
+
+  long int const len =
+    !finish(writer) || writer->error ? -1l : writer->flen;
+
+  gkeycomp_reset(data->state.comp);
+  attach(writer, data, min_size, out, false);
+  return len;
+}
+
+long int writer_gkey_reinit(Writer *const writer, long int const min_size,
+                            FILE *const out)
+{
+  assert(writer != NULL);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+  assert(out != NULL);
+  assert(!ferror(out));
+
+  long int const len =
+    !finish(writer) || writer->error ? -1l : writer->flen;
+
+  gkeycomp_reset(data->state.comp);
+  writer_raw_init(&data->raw, out);
+  attach(writer, data, min_size, &data->raw, true);
+  return len;
+}
+
+void writer_gkey_set_exact(Writer *const writer, bool const exact)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_gkey_fwrite);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+  assert(!data->state.wrote_hdr);
+
+  data->exact = exact;
+}
+
+bool writer_gkey_set_spool(Writer *const writer, size_t const threshold,
+                           long int const limit)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_gkey_fwrite);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+  assert(!data->state.wrote_hdr);
+  assert(limit >= 0);
+
+  _Optional SpillBuf *buf = NULL;
+  if (limit > 0) {
+    buf = spillbuf_make(threshold);
+    if (buf == NULL) {
+      DEBUGF("Failed to create buffer for compressed output\n");
+      return false;
+    }
+  }
+
+  spillbuf_destroy(data->spool.buf);
+  data->spool = (WriterGKeySpool){.buf = buf, .limit = limit};
+  return true;
+}
+
+void writer_gkey_set_extended(Writer *const writer, bool const extended)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_gkey_fwrite);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+  assert(!data->state.wrote_hdr);
+
+  data->extended = extended;
+}
+
+void writer_gkey_set_members(Writer *const writer, bool const members)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_gkey_fwrite);
+  WriterGKeyData *const data = writer->data;
+  assert(data != NULL);
+  assert(!data->state.wrote_hdr);
+
+  data->members = members;
+}
+
+bool writer_gkey_append_from(Writer *const writer,
+                             unsigned int const history_log_2,
+                             Writer *const out)
+{
+  assert(writer != NULL);
+  assert(out != NULL);
+
+  if (!writer_gkey_init_from(writer, history_log_2, 0, out)) {
     return false;
   }
 
-  writer_raw_init(&*raw, out);
+  writer_gkey_set_members(writer, true);
+  return true;
+}
+
+bool writer_gkey_append(Writer *const writer,
+                        unsigned int const history_log_2, FILE *const out)
+{
+  assert(writer != NULL);
+  assert(out != NULL);
+  assert(!ferror(out));
+
+  /* Find the end of any existing members */
+  if (fseek(out, 0, SEEK_END)) {
+    DEBUGF("Failed to seek end of file: %s\n", strerror(errno));
+    return false;
+  }
 
-  bool const success =
-    writer_gkey_init_from(writer, history_log_2, min_size, &*raw);
+  long int const end = ftell(out);
+  if (end < 0) {
+    DEBUGF("Failed to get end of file: %s\n", strerror(errno));
+    return false;
+  }
 
-  if (!success) {
+  _Optional WriterGKeyData *const data = make_data(history_log_2);
+  if (data == NULL) {
     DEBUGF("Failed to initialize a new writer\n");
-    (void)writer_destroy(&*raw);
-    free(raw);
-  } else {
-    WriterGKeyData *const data = writer->data;
-    data->state.owns_backend = true; /* override default */
+    return false;
   }
 
-  return success;
+  /* The raw writer's offsets are absolute file positions, so move it to
+     the end of the file to be able to find the new header again. */
+  writer_raw_init(&data->raw, out);
+  if (writer_fseek(&data->raw, end, SEEK_SET)) {
+    writer_destroy(&data->raw);
+    gkeycomp_destroy(data->state.comp);
+    free(data);
+    return false;
+  }
+
+  attach(writer, &*data, 0, &data->raw, true);
+  data->members = true;
+  return true;
 }
@@ -28,6 +28,11 @@ History:
   CJB: 27-Sep-20: Clarified that the input is padded to a minimum size, not
                   the compressed output.
   CJB: 28-Jul-22: Removed redundant use of the 'extern' keyword.
+  CJB: 18-Oct-26: Added writer_gkey_reinit and writer_gkey_reinit_from.
+                  Added writer_gkey_set_exact and writer_gkey_set_spool.
+                  Added writer_gkey_set_extended.
+                  Added writer_gkey_set_members, writer_gkey_append and
+                  writer_gkey_append_from.
 */
 
 #ifndef WriterGKey_h
@@ -70,4 +75,113 @@ bool writer_gkey_init(Writer * /*writer*/, unsigned int /*history_log_2*/,
  *          lack of free memory.
  */
 
+long int writer_gkey_reinit_from(Writer * /*writer*/, long int /*min_size*/,
+                                 Writer * /*out*/);
+/*
+ * flushes any buffered output data for an abstract writer object created
+ * by writer_gkey_init or writer_gkey_init_from, then resets it to allow
+ * data to be encoded before being written to the writer object pointed
+ * to by 'out'. This is equivalent to destroying the writer and creating
+ * a new one with the same 'history_log_2' but avoids freeing and
+ * reallocating the compressor's state. Any writer object that was
+ * implicitly created by writer_gkey_init is destroyed.
+ * Returns: the value that writer_destroy would have returned, i.e. the
+ *          number of bytes written to the previous output, or -1L on
+ *          failure. The reset succeeds regardless.
+ */
+
+long int writer_gkey_reinit(Writer * /*writer*/, long int /*min_size*/,
+                            FILE * /*out*/);
+/*
+ * flushes any buffered output data for an abstract writer object created
+ * by writer_gkey_init or writer_gkey_init_from, then resets it to allow
+ * data to be encoded before being written to a file pointed to by 'out'.
+ * This function is similar to writer_gkey_reinit_from except that it
+ * implicitly creates a writer object to allow the file to be written.
+ * Returns: the value that writer_destroy would have returned for the
+ *          previous output, or -1L on failure.
+ */
+
+void writer_gkey_set_exact(Writer * /*writer*/, bool /*exact*/);
+/*
+ * declares that 'min_size' (as passed to the function that created or
+ * last reinitialized a writer object) is the exact size of the input data
+ * rather than the minimum. The header is then never overwritten, so the
+ * output need not be seekable. Attempting to write beyond that size sets
+ * the error indicator. Must be called before any data is written.
+ * Reinitializing the writer keeps this setting.
+ */
+
+bool writer_gkey_set_spool(Writer * /*writer*/, size_t /*threshold*/,
+                           long int /*limit*/);
+/*
+ * makes a writer object created by writer_gkey_init or writer_gkey_init_from
+ * hold back up to 'limit' bytes of compressed data until it is destroyed,
+ * then write the true size of the input data followed by the held-back
+ * data. This allows output to a pipe or other non-seekable destination
+ * without knowing the size in advance. The held-back data is stored in
+ * memory until its size would exceed 'threshold' bytes, and in a temporary
+ * file thereafter. If the compressed data is longer than 'limit' then it
+ * is written as usual, with a header that may need to be corrected by
+ * seeking backward. A limit of 0 disables spooling. Has no effect whilst
+ * writer_gkey_set_exact is in force. Must be called before any data is
+ * written. Reinitializing the writer keeps the limits.
+ * Returns: true if successful, otherwise false. Can only fail because of
+ *          lack of free memory, in which case the previous limits are kept.
+ */
+
+void writer_gkey_set_extended(Writer * /*writer*/, bool /*extended*/);
+/*
+ * selects whether a writer object writes an extended header, which stores
+ * the size of the input data as a 64-bit integer instead of the classic
+ * 32-bit integer, and therefore allows more than 2 GiB of input (if long
+ * int is wide enough to count it). Data with an extended header can be
+ * read by reader_gkey_init but not by older versions of this library.
+ * The default is false. Must be called before any data is written.
+ * Reinitializing the writer keeps this setting.
+ */
+
+void writer_gkey_set_members(Writer * /*writer*/, bool /*members*/);
+/*
+ * selects whether a writer object writes its output as a member of a
+ * multi-member stream, to which further members can later be appended
+ * (see writer_gkey_append). A member has an extended header which also
+ * stores the size of the compressed data, so the header is overwritten
+ * when the writer is destroyed, unless the compressed data was held back
+ * by writer_gkey_set_spool (which is then allowed even whilst
+ * writer_gkey_set_exact is in force). reader_gkey_init reads consecutive
+ * members as one continuous stream. The default is false. Must be called
+ * before any data is written. Reinitializing the writer keeps this
+ * setting.
+ */
+
+bool writer_gkey_append_from(Writer * /*writer*/,
+                             unsigned int /*history_log_2*/,
+                             Writer * /*out*/);
+/*
+ * creates an abstract writer object to allow data to be encoded as a new
+ * member of a multi-member stream before being written to the writer
+ * object pointed to by 'out', which must already be positioned at the end
+ * of any existing members (e.g. by calling writer_fseek). This function is
+ * equivalent to calling writer_gkey_init_from with a 'min_size' of 0 then
+ * writer_gkey_set_members. The new member is compressed independently
+ * of any existing members.
+ * Returns: true if successful, otherwise false. Can only fail because of
+ *          lack of free memory.
+ */
+
+bool writer_gkey_append(Writer * /*writer*/, unsigned int /*history_log_2*/,
+                        FILE * /*out*/);
+/*
+ * creates an abstract writer object to allow data to be encoded as a new
+ * member at the end of a file pointed to by 'out', which must be empty or
+ * contain only members written by a writer object for which
+ * writer_gkey_set_members was called. The file must be open for update
+ * rather than appending, so that the new member's header can be corrected
+ * when the writer is destroyed. The file is implicitly wrapped by a second
+ * writer object, which is destroyed with its parent.
+ * Returns: true if successful, otherwise false. Fails if the end of the
+ *          file can't be found or because of lack of free memory.
+ */
+
 #endif /* WriterGKey_h */
@@ -24,6 +24,13 @@
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
   CJB: 29-Apr-26: Stop dereferencing a pointer of type void *.
   CJB: 21-May-26: Update assertions for writer position and size checks.
+  CJB: 18-Oct-26: Added writer_heap_init_with_alloc to allow the buffer to
+                  be grown by a client-supplied allocator.
+                  Added writer_heap_buffer, writer_heap_length and
+                  writer_heap_to_reader.
+                  Added support for writer_fprepare.
+                  An empty buffer is freed on destruction instead of
+                  being passed to realloc with a size of 0.
 */
 
 /* ISO library header files */
@@ -34,11 +41,14 @@
 
 /* Local headers */
 #include "Internal/StreamMisc.h"
+#include "Allocator.h"
+#include "ReaderMem.h"
 #include "WriterHeap.h"
 
 typedef struct {
   _Optional void **buffer;
   size_t buffer_size;
+  StreamAllocator alloc;
 } WriterHeapData;
 
 static void zero_extend(Writer *const writer, size_t const new_size)
@@ -66,7 +76,8 @@ static bool resize_buffer(Writer *const writer, size_t const new_size)
 
   DEBUGF("realloc from %zu to %zu for writer\n", data->buffer_size, new_size);
 
-  _Optional char *const new_buffer = realloc(*data->buffer, new_size);
+  _Optional char *const new_buffer =
+    data->alloc.realloc_fn(*data->buffer, new_size, data->alloc.ctx);
   if (new_buffer == NULL) {
     DEBUGF("realloc failed\n");
     return false;
@@ -84,6 +95,15 @@ static bool cleanup(Writer *const writer)
   assert(data != NULL);
   assert(data->buffer_size >= (unsigned long)writer->flen);
 
+  if (writer->flen == 0) {
+    /* realloc may free the buffer and return null for a size of 0,
+       which would be indistinguishable from failure. */
+    data->alloc.free_fn(*data->buffer, data->alloc.ctx);
+    *data->buffer = NULL;
+    data->buffer_size = 0;
+    return true;
+  }
+
   /* Truncate the buffer to the minimum required size */
   if ((data->buffer_size > (unsigned long)writer->flen) &&
       !resize_buffer(writer, (size_t)writer->flen)) {
@@ -92,16 +112,13 @@ static bool cleanup(Writer *const writer)
   return true;
 }
 
-static size_t writer_heap_fwrite(void const *ptr, size_t const size,
-                                 Writer *const writer)
+static bool reserve(Writer *const writer, size_t const size)
 {
-  assert(ptr != NULL);
+  /* Ensure there is room for 'size' bytes at the file position */
   assert(writer != NULL);
   WriterHeapData *const data = writer->data;
   assert(data != NULL);
   assert(writer->fpos >= 0);
-  assert(size <= (unsigned long)LONG_MAX);
-  assert(writer->fpos <= LONG_MAX - (long)size);
 
   size_t const buffer_size = data->buffer_size;
   assert(buffer_size >= (unsigned long)writer->flen);
@@ -109,19 +126,16 @@ static size_t writer_heap_fwrite(void const *ptr, size_t const size,
   if ((unsigned long)writer->fpos > SIZE_MAX - size) {
     DEBUGF("File position %ld or data size %zu is too big\n", writer->fpos,
            size);
-
-    writer->error = 1;
-    return 0;
+    return false;
   }
-  
+
   size_t newsize = (size_t)writer->fpos + size;
   if (newsize > buffer_size) {
     if ((buffer_size <= (SIZE_MAX / 2)) && ((buffer_size * 2) >= newsize)) {
       newsize = buffer_size * 2;
     }
     if (!resize_buffer(writer, newsize)) {
-      writer->error = 1;
-      return 0;
+      return false;
     }
   }
 
@@ -130,6 +144,24 @@ static size_t writer_heap_fwrite(void const *ptr, size_t const size,
     assert((unsigned long)writer->fpos <= SIZE_MAX);
     zero_extend(writer, (size_t)writer->fpos);
   }
+  return true;
+}
+
+static size_t writer_heap_fwrite(void const *ptr, size_t const size,
+                                 Writer *const writer)
+{
+  assert(ptr != NULL);
+  assert(writer != NULL);
+  WriterHeapData *const data = writer->data;
+  assert(data != NULL);
+  assert(writer->fpos >= 0);
+  assert(size <= (unsigned long)LONG_MAX);
+  assert(writer->fpos <= LONG_MAX - (long)size);
+
+  if (!reserve(writer, size)) {
+    writer->error = 1;
+    return 0;
+  }
 
   assert(data->buffer != NULL);
   assert(*data->buffer != NULL);
@@ -138,6 +170,24 @@ static size_t writer_heap_fwrite(void const *ptr, size_t const size,
   return size;
 }
 
+static _Optional void *writer_heap_prepare(size_t const min_size,
+                                           size_t *const size,
+                                           Writer *const writer)
+{
+  assert(size != NULL);
+  assert(writer != NULL);
+  WriterHeapData *const data = writer->data;
+  assert(data != NULL);
+
+  if (!reserve(writer, min_size) || *data->buffer == NULL) {
+    return NULL;
+  }
+
+  assert(data->buffer_size >= (unsigned long)writer->fpos);
+  *size = data->buffer_size - (size_t)writer->fpos;
+  return (char *)(*data->buffer) + writer->fpos;
+}
+
 static bool writer_heap_destroy(Writer *const writer)
 {
   assert(writer != NULL);
@@ -153,6 +203,14 @@ static bool writer_heap_destroy(Writer *const writer)
 
 bool writer_heap_init(Writer *const writer, _Optional void **const buffer,
                       size_t const buffer_size)
+{
+  return writer_heap_init_with_alloc(writer, buffer, buffer_size, NULL);
+}
+
+bool writer_heap_init_with_alloc(Writer *const writer,
+                                 _Optional void **const buffer,
+                                 size_t const buffer_size,
+                                 _Optional StreamAllocator const *const alloc)
 {
   assert(writer != NULL);
   assert(buffer != NULL);
@@ -167,10 +225,60 @@ bool writer_heap_init(Writer *const writer, _Optional void **const buffer,
   *data = (WriterHeapData){
     .buffer_size = buffer_size,
     .buffer = buffer,
+    .alloc = alloc ? *alloc : *stream_std_allocator(),
   };
 
-  static WriterFns const fns = {writer_heap_fwrite, writer_heap_destroy};
+  static WriterFns const fns = {writer_heap_fwrite, writer_heap_destroy,
+                                writer_heap_prepare};
   writer_internal_init(writer, &fns, &*data);
 
   return true;
 }
+
+_Optional void *writer_heap_buffer(Writer const *const writer)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_heap_fwrite);
+  WriterHeapData const *const data = writer->data;
+  assert(data != NULL);
+  assert(data->buffer != NULL);
+  return *data->buffer;
+}
+
+long int writer_heap_length(Writer const *const writer)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_heap_fwrite);
+  WriterHeapData const *const data = writer->data;
+  assert(data != NULL);
+  assert(data->buffer_size >= (unsigned long)writer->flen);
+  return writer->flen;
+}
+
+long int writer_heap_to_reader(Writer *const writer, Reader *const reader)
+{
+  assert(writer != NULL);
+  assert(writer->fns.fwrite_fn == writer_heap_fwrite);
+  assert(reader != NULL);
+  WriterHeapData *const data = writer->data;
+  assert(data != NULL);
+  assert(data->buffer != NULL);
+
+  /* Unlike writer_destroy, don't truncate the buffer because that may
+     require it to be copied. */
+  long int const len = writer->error ? -1l : writer->flen;
+  _Optional void *const buffer = *data->buffer;
+  DEBUGF("Handing over %ld of %zu bytes to a reader\n", len,
+         data->buffer_size);
+  free(data);
+
+  if (len < 0) {
+    return -1l;
+  }
+
+  if (!reader_mem_init(reader, buffer ? (char *)buffer : "", (size_t)len)) {
+    return -1l;
+  }
+
+  return len;
+}
@@ -26,6 +26,12 @@ History:
   CJB: 08-Sep-19: Add missing #include.
   CJB: 28-Jul-22: Removed redundant use of 'extern' and 'const'.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
+  CJB: 18-Oct-26: Added writer_heap_init_with_alloc.
+                  Added writer_heap_buffer, writer_heap_length and
+                  writer_heap_to_reader.
+                  An empty buffer is now freed by writer_destroy.
+                  Clarified how to allocate and free a buffer grown by
+                  a client-supplied allocator.
 */
 
 #ifndef WriterHeap_h
@@ -36,6 +42,8 @@ History:
 #include <stddef.h>
 
 /* Local header files */
+#include "Allocator.h"
+#include "Reader.h"
 #include "Writer.h"
 
 #if !defined(USE_OPTIONAL) && !defined(_Optional)
@@ -52,9 +60,69 @@ bool writer_heap_init(Writer * /*writer*/, _Optional void ** /*buffer*/,
  * grow the buffer as necessary (by calling realloc) without taking
  * ownership of it. The initial size of the buffer (in bytes) is
  * specified by 'buffer_size'; its final size is returned by
- * writer_destroy.
+ * writer_destroy. If no data was written then the buffer is freed and
+ * null is stored as its address.
  * Returns: true if successful, otherwise false. Can only fail because
  *          of a lack of free memory.
  */
 
+bool writer_heap_init_with_alloc(Writer * /*writer*/,
+                                 _Optional void ** /*buffer*/,
+                                 size_t /*buffer_size*/,
+                                 _Optional StreamAllocator const * /*alloc*/);
+/*
+ * creates an abstract writer object to allow data to be stored in a buffer
+ * which is grown (or truncated) by calling the realloc_fn member of the
+ * object pointed to by 'alloc' instead of the standard C library's realloc
+ * function (or freed by calling its free_fn member). Otherwise, this
+ * function is similar to writer_heap_init.
+ * The contents of the allocator object are copied. If 'alloc' is null
+ * then the standard C library is used. In all cases, the buffer is
+ * independent of any allocator installed by stream_set_allocator.
+ * If the initial address stored at 'buffer' is not null then the buffer
+ * must have been allocated by the same allocator, not by malloc (unless
+ * the allocator accepts blocks allocated by malloc, as page_allocator
+ * does). Likewise, the caller must free the final buffer by calling the
+ * allocator's free_fn member, not free, unless the allocator documents
+ * otherwise. See page_allocator for an allocator suited to very large
+ * buffers, whose blocks smaller than 128 KiB can also be freed by
+ * calling free.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+_Optional void *writer_heap_buffer(Writer const * /*writer*/);
+/*
+ * gets the current address of the buffer used by a writer object that
+ * was created by writer_heap_init or writer_heap_init_with_alloc. The
+ * address may change whenever data is written. Only the first
+ * writer_heap_length bytes of the buffer are valid; the file position
+ * may be beyond them (after seeking forward without writing) or before
+ * them (after seeking backward).
+ * Returns: the address of the buffer, or null if none is allocated.
+ */
+
+long int writer_heap_length(Writer const * /*writer*/);
+/*
+ * gets the extent of the data written so far by a writer object that was
+ * created by writer_heap_init or writer_heap_init_with_alloc, which is
+ * one beyond the highest offset at which a byte has been written. This
+ * never exceeds the allocated size of the buffer.
+ * Returns: the number of valid bytes at the start of the buffer.
+ */
+
+long int writer_heap_to_reader(Writer * /*writer*/, Reader * /*reader*/);
+/*
+ * destroys a writer object that was created by writer_heap_init or
+ * writer_heap_init_with_alloc, and creates a reader object to allow the
+ * data that was written to be read from the same buffer without copying
+ * it. Unlike writer_destroy, this function does not truncate the buffer,
+ * so its size may be greater than the length of the data. The buffer
+ * remains owned by the caller and must not be freed until the reader
+ * object has been destroyed. If this function fails then the writer
+ * object is still destroyed but no reader object is created.
+ * Returns: the length of the data (in bytes), or -1 if the writer's
+ *          error indicator was set or there was not enough free memory.
+ */
+
 #endif /* WriterHeap_h */
@@ -22,6 +22,7 @@
   CJB: 07-Sep-19: First released version.
   CJB: 28-Nov-20: Initialize struct using compound literal assignment.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
+  CJB: 18-Oct-26: Added support for writer_fprepare.
 */
 
 /* ISO library header files */
@@ -93,6 +94,31 @@ static size_t writer_mem_fwrite(void const *ptr, size_t const size,
   return nwrite;
 }
 
+static _Optional void *writer_mem_prepare(size_t const min_size,
+                                          size_t *const size,
+                                          Writer *const writer)
+{
+  assert(size != NULL);
+  assert(writer != NULL);
+  WriterMemData *const data = writer->data;
+  assert(data != NULL);
+  assert(writer->fpos >= 0);
+
+  if (data->buffer == NULL ||
+      (unsigned long)writer->fpos > data->buffer_size ||
+      data->buffer_size - (size_t)writer->fpos < min_size) {
+    return NULL;
+  }
+
+  if (writer->fpos > writer->flen) {
+    /* To simulate a sparse file, zero-initialize skipped bytes. */
+    zero_extend(writer, (size_t)writer->fpos);
+  }
+
+  *size = data->buffer_size - (size_t)writer->fpos;
+  return &*data->buffer + writer->fpos;
+}
+
 static bool writer_mem_destroy(Writer *const writer)
 {
   assert(writer != NULL);
@@ -117,7 +143,8 @@ bool writer_mem_init(Writer *const writer, _Optional void *const buffer,
     .buffer_size = buffer_size,
   };
 
-  static WriterFns const fns = {writer_mem_fwrite, writer_mem_destroy};
+  static WriterFns const fns = {writer_mem_fwrite, writer_mem_destroy,
+                                writer_mem_prepare};
   writer_internal_init(writer, &fns, &*data);
 
   return true;
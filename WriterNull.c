@@ -47,6 +47,6 @@ static bool writer_null_destroy(Writer *const writer)
 void writer_null_init(Writer *const writer)
 {
   assert(writer != NULL);
-  static WriterFns const fns = {writer_null_fwrite, writer_null_destroy};
+  static WriterFns const fns = {writer_null_fwrite, writer_null_destroy, NULL};
   writer_internal_init(writer, &fns, writer);
 }
@@ -0,0 +1,136 @@
+/*
+ * StreamLib: Pipe writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+                  A full pipe no longer sets the error indicator.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "WriterPipe.h"
+
+enum {
+  ZeroBufferSize = 256,
+};
+
+typedef struct {
+  Pipe *pipe;
+  long int pos; /* number of bytes written to the pipe */
+  bool blocking;
+} WriterPipeData;
+
+static bool zero_extend(Writer *const writer)
+{
+  assert(writer != NULL);
+  WriterPipeData *const data = writer->data;
+  assert(data != NULL);
+
+  /* A pipe can't be rewound, but seeking forward can be simulated by
+     writing zeros. */
+  if (writer->fpos < data->pos) {
+    DEBUGF("Can't seek backward from %ld to %ld\n", data->pos, writer->fpos);
+    writer->error = 1;
+    return false;
+  }
+
+  static char const zeros[ZeroBufferSize];
+  while (data->pos < writer->fpos) {
+    size_t n = sizeof(zeros);
+    if ((unsigned long)(writer->fpos - data->pos) < n) {
+      n = (size_t)(writer->fpos - data->pos);
+    }
+
+    size_t const nwritten = pipe_write(data->pipe, zeros, n, data->blocking);
+    data->pos += (long)nwritten;
+    if (nwritten != n) {
+      /* A full pipe isn't an error, so the caller can try again later */
+      DEBUGF("Failed to zero-extend to %ld\n", writer->fpos);
+      if (pipe_broken(data->pipe)) {
+        writer->error = 1;
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static size_t writer_pipe_fwrite(void const *ptr, size_t const size,
+                                 Writer *const writer)
+{
+  assert(ptr != NULL);
+  assert(writer != NULL);
+  WriterPipeData *const data = writer->data;
+  assert(data != NULL);
+  assert(writer->fpos >= 0);
+
+  if (writer->fpos != data->pos && !zero_extend(writer)) {
+    return 0;
+  }
+
+  size_t const nwritten = pipe_write(data->pipe, ptr, size, data->blocking);
+  data->pos += (long)nwritten;
+  if (nwritten != size) {
+    DEBUGF("%zu of %zu bytes written\n", nwritten, size);
+    if (pipe_broken(data->pipe)) {
+      writer->error = 1;
+    }
+  }
+  return nwritten;
+}
+
+static bool writer_pipe_destroy(Writer *const writer)
+{
+  assert(writer != NULL);
+  WriterPipeData *const data = writer->data;
+  assert(data != NULL);
+
+  pipe_close_write(data->pipe);
+  free(data);
+  return true;
+}
+
+bool writer_pipe_init(Writer *const writer, Pipe *const pipe,
+                      bool const blocking)
+{
+  assert(writer != NULL);
+  assert(pipe != NULL);
+
+  _Optional WriterPipeData *const data = malloc(sizeof(*data));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new writer\n");
+    return false;
+  }
+
+  *data = (WriterPipeData){
+    .pipe = pipe,
+    .pos = 0,
+    .blocking = blocking,
+  };
+
+  static WriterFns const fns = {writer_pipe_fwrite, writer_pipe_destroy, NULL};
+  writer_internal_init(writer, &fns, &*data);
+
+  return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * StreamLib: Pipe writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library, POSIX threads.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+                  A full pipe no longer sets the error indicator.
+*/
+
+#ifndef WriterPipe_h
+#define WriterPipe_h
+
+/* ISO library header files */
+#include <stdbool.h>
+
+/* Local header files */
+#include "Pipe.h"
+#include "Writer.h"
+
+bool writer_pipe_init(Writer * /*writer*/, Pipe * /*pipe*/,
+                      bool /*blocking*/);
+/*
+ * creates an abstract writer object to allow data to be written to the
+ * producer's end of a pipe, typically in a different thread from the
+ * reader object at the consumer's end. If 'blocking' is true then writes
+ * wait for space in the pipe's buffer; otherwise a write only copies as
+ * much data as fits, and a short write without the error indicator set
+ * means that the buffer is full and the rest can be retried later (see
+ * pipe_space). The error indicator is only set if the consumer's end has
+ * been closed (see pipe_broken). Seeking
+ * forward writes zeros but seeking backward is not supported. Destroying
+ * the writer closes the producer's end, which allows the reader to
+ * detect the end of the data.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* WriterPipe_h */
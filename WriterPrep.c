@@ -0,0 +1,73 @@
+/*
+ * StreamLib: Write output without copying it
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <limits.h>
+#include <stdio.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "Writer.h"
+
+_Optional void *writer_fprepare(Writer *const writer, size_t const min_size,
+                                size_t *const size)
+{
+  assert(writer != NULL);
+  assert(size != NULL);
+  assert(writer->fpos >= 0);
+
+  *size = 0;
+
+  if (writer->error || writer->fns.prepare_fn == NULL ||
+      min_size > (unsigned long)(LONG_MAX - writer->fpos)) {
+    return NULL;
+  }
+
+  _Optional void *const ptr = writer->fns.prepare_fn(min_size, size, writer);
+  if (ptr == NULL || *size == 0) {
+    *size = 0;
+    return NULL;
+  }
+
+  /* Committing the whole storage must not overflow the file position */
+  if (*size > (unsigned long)(LONG_MAX - writer->fpos)) {
+    *size = (size_t)(LONG_MAX - writer->fpos);
+  }
+
+  DEBUG_VERBOSEF("Prepared %zu bytes at %ld\n", *size, writer->fpos);
+  return ptr;
+}
+
+void writer_fcommit(Writer *const writer, size_t const size)
+{
+  assert(writer != NULL);
+  assert(writer->fpos >= 0);
+  assert(!writer->error);
+  assert(size <= (unsigned long)(LONG_MAX - writer->fpos));
+
+  DEBUG_VERBOSEF("Committed %zu bytes at %ld\n", size, writer->fpos);
+  writer->fpos += (long)size;
+  if (writer->fpos > writer->flen) {
+    writer->flen = writer->fpos;
+  }
+}
@@ -21,6 +21,7 @@
   CJB: 11-Aug-19: Created this source file.
   CJB: 07-Sep-19: First released version.
   CJB: 09-Apr-25: Dogfooding the _Optional qualifier.
+  CJB: 18-Oct-26: Added writer_raw_file.
 */
 
 /* ISO library header files */
@@ -85,6 +86,12 @@ void writer_raw_init(Writer *const writer, FILE *const out)
   assert(out != NULL);
   assert(!ferror(out));
 
-  static WriterFns const fns = {writer_raw_fwrite, writer_raw_destroy};
+  static WriterFns const fns = {writer_raw_fwrite, writer_raw_destroy, NULL};
   writer_internal_init(writer, &fns, out);
 }
+
+_Optional FILE *writer_raw_file(Writer const *const writer)
+{
+  assert(writer != NULL);
+  return writer->fns.fwrite_fn == writer_raw_fwrite ? writer->data : NULL;
+}
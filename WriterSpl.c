@@ -0,0 +1,63 @@
+/*
+ * StreamLib: Spilling memory buffer writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "WriterSpl.h"
+
+static size_t writer_spill_fwrite(void const *ptr, size_t const size,
+                                  Writer *const writer)
+{
+  assert(ptr != NULL);
+  assert(writer != NULL);
+  SpillBuf *const buf = writer->data;
+  assert(buf != NULL);
+  assert(writer->fpos >= 0);
+
+  size_t const nwritten = spillbuf_write(buf, writer->fpos, ptr, size);
+  if (nwritten != size) {
+    DEBUGF("%zu of %zu bytes written\n", nwritten, size);
+    writer->error = 1;
+  }
+  return nwritten;
+}
+
+static bool writer_spill_destroy(Writer *const writer)
+{
+  NOT_USED(writer);
+  return true;
+}
+
+void writer_spill_init(Writer *const writer, SpillBuf *const buf)
+{
+  assert(writer != NULL);
+  assert(buf != NULL);
+
+  static WriterFns const fns = {writer_spill_fwrite, writer_spill_destroy,
+                                NULL};
+  writer_internal_init(writer, &fns, buf);
+}
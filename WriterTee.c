@@ -0,0 +1,131 @@
+/*
+ * StreamLib: Writer which copies output to other writers
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Local headers */
+#include "Internal/StreamMisc.h"
+#include "WriterTee.h"
+
+typedef struct {
+  size_t nchildren;
+  Writer *children[];
+} WriterTeeData;
+
+static size_t writer_tee_fwrite(void const *ptr, size_t const size,
+                                Writer *const writer)
+{
+  assert(ptr != NULL);
+  assert(writer != NULL);
+  WriterTeeData *const data = writer->data;
+  assert(data != NULL);
+  assert(writer->fpos >= 0);
+
+  if (data->nchildren == 0) {
+    return size;
+  }
+
+  /* Each child has its own error indicator, so write as much as possible
+     to each one and only fail if every child failed. */
+  size_t best = 0;
+  for (size_t i = 0; i < data->nchildren; ++i) {
+    Writer *const child = data->children[i];
+    if (writer_ferror(child)) {
+      continue;
+    }
+
+    /* Replay any seek (e.g. back to a header to be patched) before
+       writing. It's up to the child whether it supports that. */
+    if (writer_ftell(child) != writer->fpos &&
+        writer_fseek(child, writer->fpos, SEEK_SET)) {
+      DEBUGF("Failed to seek child %zu to %ld\n", i, writer->fpos);
+      continue;
+    }
+
+    size_t const n = writer_fwrite(ptr, 1, size, child);
+    if (n != size) {
+      DEBUGF("%zu of %zu bytes written to child %zu\n", n, size, i);
+    }
+    if (n > best) {
+      best = n;
+    }
+  }
+
+  if (best != size) {
+    DEBUGF("All children failed\n");
+    writer->error = 1;
+  }
+  return best;
+}
+
+static bool writer_tee_destroy(Writer *const writer)
+{
+  assert(writer != NULL);
+  WriterTeeData *const data = writer->data;
+  assert(data != NULL);
+
+  bool ok = data->nchildren == 0;
+  for (size_t i = 0; i < data->nchildren; ++i) {
+    if (!writer_ferror(data->children[i])) {
+      ok = true;
+    }
+  }
+
+  free(data);
+  return ok;
+}
+
+bool writer_tee_init(Writer *const writer, Writer *const *const children,
+                     size_t const nchildren)
+{
+  assert(writer != NULL);
+  assert(nchildren == 0 || children != NULL);
+
+  if (nchildren > (SIZE_MAX - sizeof(WriterTeeData)) /
+                  sizeof(Writer *)) {
+    DEBUGF("Too many children\n");
+    return false;
+  }
+
+  _Optional WriterTeeData *const data =
+    malloc(sizeof(*data) + nchildren * sizeof(data->children[0]));
+  if (data == NULL) {
+    DEBUGF("Failed to allocate memory for a new writer\n");
+    return false;
+  }
+
+  data->nchildren = nchildren;
+  for (size_t i = 0; i < nchildren; ++i) {
+    assert(children[i] != NULL);
+    data->children[i] = children[i];
+  }
+
+  static WriterFns const fns = {writer_tee_fwrite, writer_tee_destroy, NULL};
+  writer_internal_init(writer, &fns, &*data);
+
+  return true;
+}
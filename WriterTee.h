@@ -0,0 +1,54 @@
+/*
+ * StreamLib: Writer which copies output to other writers
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+Dependencies: ANSI C library.
+Message tokens: None.
+History:
+  CJB: 18-Oct-26: Created this source file.
+*/
+
+#ifndef WriterTee_h
+#define WriterTee_h
+
+/* ISO library header files */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Local header files */
+#include "Writer.h"
+
+bool writer_tee_init(Writer * /*writer*/, Writer *const * /*children*/,
+                     size_t /*nchildren*/);
+/*
+ * creates an abstract writer object to allow the same data to be written
+ * to each of an array of 'nchildren' other writer objects, e.g. to
+ * produce a compressed file, an uncompressed copy and a compressed size
+ * estimate in one pass. Seeking is passed on to the other writers, so
+ * output can be overwritten (as by writer_gkey_init_from) if they
+ * support that. Each of the other writers has its own error indicator,
+ * which is set independently and can be got by calling writer_ferror.
+ * Writing only fails (and sets the error indicator) if it failed for all
+ * of the other writers. The other writers are not destroyed with this
+ * one, and must not be destroyed until after it.
+ * Returns: true if successful, otherwise false. Can only fail because
+ *          of a lack of free memory.
+ */
+
+#endif /* WriterTee_h */
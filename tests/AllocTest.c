@@ -0,0 +1,262 @@
+/*
+ * StreamLib test: Memory allocator hooks
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "Allocator.h"
+#include "PageAlloc.h"
+#include "ReaderMem.h"
+#include "WriterHeap.h"
+
+/* Local headers */
+#include "Tests.h"
+
+#define TEST_STR "qwerty"
+
+enum {
+  LongDataSize = 320,
+  HugeDataSize = 300 * 1024, /* greater than the mapping threshold */
+  BlockSize = 1000,
+};
+
+typedef struct {
+  unsigned long nalloc, nrealloc, nfree;
+} Counts;
+
+static _Optional void *count_alloc(size_t const size, void *const ctx)
+{
+  Counts *const counts = ctx;
+  ++counts->nalloc;
+  return malloc(size);
+}
+
+static _Optional void *count_realloc(_Optional void *const ptr,
+                                     size_t const size, void *const ctx)
+{
+  Counts *const counts = ctx;
+  ++counts->nrealloc;
+  return realloc((void *)ptr, size);
+}
+
+static void count_free(_Optional void *const ptr, void *const ctx)
+{
+  Counts *const counts = ctx;
+  if (ptr) {
+    ++counts->nfree;
+  }
+  free(ptr);
+}
+
+static void test1(void)
+{
+  /* Hooks used for reader state */
+  Counts counts = {0, 0, 0};
+  StreamAllocator const alloc = {count_alloc, count_realloc, count_free,
+                                 &counts};
+  stream_set_allocator(&alloc);
+
+  Reader r;
+  assert(reader_mem_init(&r, TEST_STR, strlen(TEST_STR)));
+  assert(counts.nalloc == 1);
+  assert(reader_fgetc(&r) == TEST_STR[0]);
+  reader_destroy(&r);
+  assert(counts.nfree == 1);
+
+  stream_set_allocator(NULL);
+
+  assert(reader_mem_init(&r, TEST_STR, strlen(TEST_STR)));
+  reader_destroy(&r);
+  assert(counts.nalloc == 1);
+  assert(counts.nfree == 1);
+}
+
+static void test2(void)
+{
+  /* Heap buffer is independent of installed hooks */
+  Counts counts = {0, 0, 0};
+  StreamAllocator const alloc = {count_alloc, count_realloc, count_free,
+                                 &counts};
+  stream_set_allocator(&alloc);
+
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+  assert(writer_fwrite(TEST_STR, strlen(TEST_STR), 1, &w) == 1);
+  assert(writer_destroy(&w) == (long)strlen(TEST_STR));
+
+  stream_set_allocator(NULL);
+
+  assert(counts.nalloc == 1);
+  assert(counts.nrealloc == 0);
+  assert(counts.nfree == 1);
+  assert(buf != NULL);
+  assert(!memcmp((char *)buf, TEST_STR, strlen(TEST_STR)));
+  free(buf);
+}
+
+static void test3(void)
+{
+  /* Heap buffer grown by per-writer allocator */
+  Counts counts = {0, 0, 0};
+  StreamAllocator const alloc = {count_alloc, count_realloc, count_free,
+                                 &counts};
+
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init_with_alloc(&w, &buf, 0, &alloc));
+  for (size_t i = 0; i < LongDataSize; ++i) {
+    assert(writer_fputc((unsigned char)i, &w) == (unsigned char)i);
+  }
+  assert(writer_destroy(&w) == LongDataSize);
+
+  assert(counts.nalloc == 0);
+  assert(counts.nrealloc > 0);
+  assert(counts.nfree == 0);
+  assert(buf != NULL);
+  for (size_t i = 0; i < LongDataSize; ++i) {
+    assert(((unsigned char *)buf)[i] == (unsigned char)i);
+  }
+  count_free(buf, &counts);
+  assert(counts.nfree == 1);
+}
+
+static void test4(void)
+{
+  /* Heap buffer grown by page allocator */
+  static unsigned char block[BlockSize];
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    block[i] = (unsigned char)(i * 7);
+  }
+
+  for (int huge = 0; huge <= 1; ++huge) {
+    StreamAllocator const *const alloc = page_allocator(huge);
+    _Optional void *buf = NULL;
+    Writer w;
+    assert(writer_heap_init_with_alloc(&w, &buf, 0, alloc));
+
+    for (size_t n = 0; n < HugeDataSize; n += BlockSize) {
+      assert(writer_fwrite(block, BlockSize, 1, &w) == 1);
+    }
+    long int const len = writer_destroy(&w);
+    assert(len >= HugeDataSize);
+    assert(len % BlockSize == 0);
+
+    assert(buf != NULL);
+    for (long int i = 0; i < len; ++i) {
+      assert(((unsigned char *)buf)[i] == block[i % BlockSize]);
+    }
+    alloc->free_fn(buf, alloc->ctx);
+  }
+}
+
+static void test5(void)
+{
+  /* Page allocator keeps the malloc contract for small blocks */
+  for (int huge = 0; huge <= 1; ++huge) {
+    StreamAllocator const *const alloc = page_allocator(huge);
+
+    /* Start from a buffer allocated by malloc */
+    _Optional void *buf = malloc(sizeof(TEST_STR) - 1);
+    assert(buf != NULL);
+
+    Writer w;
+    assert(writer_heap_init_with_alloc(&w, &buf, sizeof(TEST_STR) - 1,
+                                       alloc));
+    assert(writer_fwrite(TEST_STR, sizeof(TEST_STR) - 1, 1, &w) == 1);
+    assert(writer_fwrite(TEST_STR, sizeof(TEST_STR) - 1, 1, &w) == 1);
+    assert(writer_destroy(&w) == (sizeof(TEST_STR) - 1) * 2);
+
+    /* Small enough to have been allocated by malloc */
+    assert(buf != NULL);
+    assert(!memcmp((void *)buf, TEST_STR TEST_STR,
+                   (sizeof(TEST_STR) - 1) * 2));
+    free(buf);
+
+    /* A mapped block becomes a malloc block when it shrinks */
+    _Optional unsigned char *big = alloc->alloc_fn(HugeDataSize, alloc->ctx);
+    assert(big != NULL);
+    for (size_t i = 0; i < HugeDataSize; ++i) {
+      big[i] = (unsigned char)i;
+    }
+
+    _Optional unsigned char *const small =
+        alloc->realloc_fn(big, LongDataSize, alloc->ctx);
+    assert(small != NULL);
+    for (size_t i = 0; i < LongDataSize; ++i) {
+      assert(small[i] == (unsigned char)i);
+    }
+    free(small);
+  }
+}
+
+static void test6(void)
+{
+  /* Page allocator grows a buffer allocated by malloc */
+  static unsigned char block[BlockSize];
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    block[i] = (unsigned char)(i * 3);
+  }
+
+  StreamAllocator const *const alloc = page_allocator(false);
+  _Optional void *buf = malloc(BlockSize);
+  assert(buf != NULL);
+
+  Writer w;
+  assert(writer_heap_init_with_alloc(&w, &buf, BlockSize, alloc));
+  for (size_t n = 0; n < HugeDataSize; n += BlockSize) {
+    assert(writer_fwrite(block, BlockSize, 1, &w) == 1);
+  }
+  long int const len = writer_destroy(&w);
+  assert(len >= HugeDataSize);
+
+  assert(buf != NULL);
+  for (long int i = 0; i < len; ++i) {
+    assert(((unsigned char *)buf)[i] == block[i % BlockSize]);
+  }
+  alloc->free_fn(buf, alloc->ctx);
+}
+
+void Alloc_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Hooks used for reader state", test1},
+    {"Heap buffer is independent of installed hooks", test2},
+    {"Heap buffer grown by per-writer allocator", test3},
+    {"Heap buffer grown by page allocator", test4},
+    {"Page allocator keeps the malloc contract for small blocks", test5},
+    {"Page allocator grows a buffer allocated by malloc", test6},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
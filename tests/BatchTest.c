@@ -0,0 +1,248 @@
+/*
+ * StreamLib test: Batch Gordon Key (de)compression
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "GKeyBatch.h"
+#include "GKeyBuf.h"
+#include "ReaderMem.h"
+#include "WriterGKey.h"
+#include "WriterHeap.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum {
+  HistoryLog2 = 9,
+  OtherHistoryLog2 = 10,
+  NumberOfJobs = 40,
+  MaxDataSize = 1000,
+  BadJob = 7,
+};
+
+typedef struct {
+  size_t ncalls, last;
+} Progress;
+
+static void make_data(unsigned char *const data, size_t const size,
+                      unsigned int const seed)
+{
+  for (size_t n = 0; n < size; ++n) {
+    data[n] = (unsigned char)((n * seed) ^ (n >> 3));
+  }
+}
+
+static size_t data_size(size_t const i)
+{
+  return (i * 97) % MaxDataSize;
+}
+
+static unsigned int history(size_t const i)
+{
+  /* Vary the history size to check that decompressors are recreated */
+  return i % 5 == 0 ? OtherHistoryLog2 : HistoryLog2;
+}
+
+static void progress(size_t const ndone, size_t const njobs, void *arg)
+{
+  Progress *const p = arg;
+  assert(njobs == NumberOfJobs);
+  assert(ndone == p->last + 1);
+  p->last = ndone;
+  p->ncalls++;
+}
+
+static void run_batch(unsigned int const nthreads)
+{
+  _Optional void *in_bufs[NumberOfJobs] = {NULL};
+  _Optional void *out_bufs[NumberOfJobs] = {NULL};
+  long int in_lens[NumberOfJobs];
+  Reader readers[NumberOfJobs];
+  Writer writers[NumberOfJobs];
+  GKeyBatchJob jobs[NumberOfJobs];
+  unsigned char data[MaxDataSize];
+
+  for (size_t i = 0; i < NumberOfJobs; ++i) {
+    Writer heap, w;
+    assert(writer_heap_init(&heap, &in_bufs[i], 0));
+    assert(writer_gkey_init_from(&w, history(i), 0, &heap));
+    make_data(data, data_size(i), (unsigned int)i);
+    assert(writer_fwrite(data, data_size(i), 1, &w) == 1 ||
+           data_size(i) == 0);
+    assert(writer_destroy(&w) == (long int)data_size(i));
+    in_lens[i] = writer_destroy(&heap);
+    assert(in_lens[i] > 0);
+
+    /* Truncate one of the inputs */
+    size_t const in_len = i == BadJob ? (size_t)in_lens[i] / 2 :
+                                        (size_t)in_lens[i];
+    assert(reader_mem_init(&readers[i], (void *)in_bufs[i], in_len));
+    assert(writer_heap_init(&writers[i], &out_bufs[i], 0));
+    jobs[i] = (GKeyBatchJob){
+      .in = &readers[i],
+      .out = &writers[i],
+      .history_log_2 = history(i),
+      .result = 0,
+    };
+  }
+
+  Progress p = {0, 0};
+  assert(gkey_batch_decompress(jobs, NumberOfJobs, nthreads, progress, &p) ==
+         NumberOfJobs - 1);
+  assert(p.ncalls == NumberOfJobs);
+
+  for (size_t i = 0; i < NumberOfJobs; ++i) {
+    reader_destroy(&readers[i]);
+    long int const len = writer_destroy(&writers[i]);
+
+    if (i == BadJob) {
+      assert(jobs[i].result == -1);
+    } else {
+      assert(jobs[i].result == (long int)data_size(i));
+      assert(len == jobs[i].result);
+      make_data(data, data_size(i), (unsigned int)i);
+      assert(data_size(i) == 0 ||
+             !memcmp(data, (void *)out_bufs[i], data_size(i)));
+    }
+
+    free(in_bufs[i]);
+    free(out_bufs[i]);
+  }
+}
+
+static void run_comp_batch(unsigned int const nthreads)
+{
+  _Optional void *out_bufs[NumberOfJobs] = {NULL};
+  static unsigned char in_data[NumberOfJobs][MaxDataSize];
+  Reader readers[NumberOfJobs];
+  Writer writers[NumberOfJobs];
+  GKeyBatchCompJob jobs[NumberOfJobs];
+
+  for (size_t i = 0; i < NumberOfJobs; ++i) {
+    make_data(in_data[i], data_size(i), (unsigned int)i);
+    assert(reader_mem_init(&readers[i], in_data[i], data_size(i)));
+    jobs[i] = (GKeyBatchCompJob){
+      .in = &readers[i],
+      .history_log_2 = history(i),
+    };
+  }
+
+  Progress p = {0, 0};
+  assert(gkey_batch_estimate(jobs, NumberOfJobs, nthreads, progress, &p) ==
+         NumberOfJobs);
+  assert(p.ncalls == NumberOfJobs);
+
+  /* Preallocate the output using the estimates */
+  for (size_t i = 0; i < NumberOfJobs; ++i) {
+    assert(jobs[i].estimate >= (long)sizeof(int32_t));
+    assert(reader_ftell(&readers[i]) == 0);
+    out_bufs[i] = malloc((size_t)jobs[i].estimate);
+    assert(out_bufs[i] != NULL);
+    assert(writer_heap_init(&writers[i], &out_bufs[i],
+                            (size_t)jobs[i].estimate));
+    jobs[i].out = &writers[i];
+  }
+
+  p = (Progress){0, 0};
+  assert(gkey_batch_compress(jobs, NumberOfJobs, nthreads, progress, &p) ==
+         NumberOfJobs);
+  assert(p.ncalls == NumberOfJobs);
+
+  unsigned char data[MaxDataSize];
+  for (size_t i = 0; i < NumberOfJobs; ++i) {
+    reader_destroy(&readers[i]);
+    long int const len = writer_destroy(&writers[i]);
+    assert(jobs[i].result == (long int)data_size(i));
+    assert(len == jobs[i].estimate);
+
+    assert(gkey_decompress_buffer(history(i), (void *)out_bufs[i],
+                                  (size_t)len, data, sizeof(data)) ==
+           (long int)data_size(i));
+    assert(data_size(i) == 0 || !memcmp(data, in_data[i], data_size(i)));
+    free(out_bufs[i]);
+  }
+}
+
+static void test1(void)
+{
+  /* One thread */
+  run_batch(1);
+}
+
+static void test2(void)
+{
+  /* Several threads */
+  run_batch(4);
+}
+
+static void test3(void)
+{
+  /* One thread per processor */
+  run_batch(0);
+}
+
+static void test4(void)
+{
+  /* No jobs */
+  assert(gkey_batch_decompress(NULL, 0, 0, NULL, NULL) == 0);
+  assert(gkey_batch_estimate(NULL, 0, 0, NULL, NULL) == 0);
+  assert(gkey_batch_compress(NULL, 0, 0, NULL, NULL) == 0);
+}
+
+static void test5(void)
+{
+  /* Estimate and compress on one thread */
+  run_comp_batch(1);
+}
+
+static void test6(void)
+{
+  /* Estimate and compress on several threads */
+  run_comp_batch(4);
+}
+
+void Batch_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"One thread", test1},
+    {"Several threads", test2},
+    {"One thread per processor", test3},
+    {"No jobs", test4},
+    {"Estimate and compress on one thread", test5},
+    {"Estimate and compress on several threads", test6},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
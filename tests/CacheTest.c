@@ -0,0 +1,455 @@
+/*
+ * StreamLib test: Page-caching reader
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "GKeyCache.h"
+#include "ReaderCach.h"
+#include "ReaderGKey.h"
+#include "ReaderMem.h"
+#include "WriterGKey.h"
+#include "WriterHeap.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum {
+  HistoryLog2 = 9,
+  DataSize = 100,
+  PageSize = 10,
+  NumPages = 3,
+  LongDataSize = 10000,
+  LongPageSize = 64,
+  NumSeeks = 1000,
+  CacheBudget = 1 << 20,
+};
+
+static void make_data(unsigned char *const data, size_t const size,
+                      unsigned int const seed)
+{
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = (unsigned char)(((i * i) + seed) % 251);
+  }
+}
+
+static void write_file(char const *const file_name,
+                       unsigned char const *const data, size_t const size)
+{
+  _Optional FILE *const f = fopen(file_name, "wb");
+  assert(f != NULL);
+  Writer w;
+  assert(writer_gkey_init(&w, HistoryLog2, 0, &*f));
+  assert(writer_fwrite(data, size, 1, &w) == 1);
+  assert(writer_destroy(&w) == (long)size);
+  assert(!fclose(&*f));
+}
+
+static void write_members(char const *const file_name,
+                          unsigned char const *const data, size_t const size,
+                          size_t const split)
+{
+  assert(split <= size);
+  _Optional FILE *const f = fopen(file_name, "w+b");
+  assert(f != NULL);
+  Writer w;
+  assert(writer_gkey_init(&w, HistoryLog2, 0, &*f));
+  writer_gkey_set_members(&w, true);
+  assert(writer_fwrite(data, split, 1, &w) == (split ? 1 : 0));
+  assert(writer_destroy(&w) >= 0);
+
+  assert(writer_gkey_append(&w, HistoryLog2, &*f));
+  assert(writer_fwrite(data + split, size - split, 1, &w) ==
+         (size > split ? 1 : 0));
+  assert(writer_destroy(&w) >= 0);
+  assert(!fclose(&*f));
+}
+
+static void read_cached(char const *const file_name,
+                        unsigned char const *const data, size_t const size)
+{
+  static unsigned char rdata[LongDataSize];
+  assert(size <= sizeof(rdata));
+
+  _Optional FILE *const f = fopen(file_name, "rb");
+  assert(f != NULL);
+  Reader r;
+  assert(reader_gkey_init_cached(&r, HistoryLog2, &*f));
+  assert(reader_fread(rdata, size, 1, &r) == 1);
+  assert(!memcmp(rdata, data, size));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+
+  /* Seeking backward doesn't need the file */
+  assert(!reader_fseek(&r, 0, SEEK_SET));
+  assert(reader_fgetc(&r) == data[0]);
+  reader_destroy(&r);
+  assert(!fclose(&*f));
+}
+
+static void check_stats(Reader const *const r, unsigned long const hits,
+                        unsigned long const misses,
+                        unsigned long const evictions)
+{
+  ReaderCacheStats stats;
+  reader_cache_stats(r, &stats);
+  assert(stats.hits == hits);
+  assert(stats.misses == misses);
+  assert(stats.evictions == evictions);
+}
+
+static void test1(void)
+{
+  /* Hits, misses and evictions */
+  unsigned char data[DataSize];
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = (unsigned char)i;
+  }
+
+  Reader mem, r;
+  assert(reader_mem_init(&mem, data, sizeof(data)));
+  assert(reader_cache_init(&r, &mem, PageSize, PageSize * NumPages));
+  check_stats(&r, 0, 0, 0);
+
+  static const struct {
+    long int pos;
+    unsigned long hits, misses, evictions;
+  } steps[] = {
+    {0, 0, 1, 0},
+    {5, 1, 1, 0},
+    {15, 1, 2, 0},
+    {25, 1, 3, 0},
+    {35, 1, 4, 1}, /* evicts the page at 0 */
+    {16, 2, 4, 1},
+    {0, 2, 5, 2}, /* evicts the page at 20 */
+    {39, 3, 5, 2},
+    {25, 3, 6, 3}, /* evicts the page at 10 */
+  };
+
+  for (size_t i = 0; i < ARRAY_SIZE(steps); ++i) {
+    assert(!reader_fseek(&r, steps[i].pos, SEEK_SET));
+    assert(reader_fgetc(&r) == data[steps[i].pos]);
+    check_stats(&r, steps[i].hits, steps[i].misses, steps[i].evictions);
+  }
+
+  /* Peeking also uses the cache */
+  size_t size;
+  _Optional const unsigned char *const p = reader_fpeek(&r, &size);
+  assert(p != NULL);
+  assert(size == PageSize - 6);
+  assert(!memcmp((const void *)p, data + 26, size));
+  check_stats(&r, 4, 6, 3);
+
+  /* Reading the last page */
+  assert(!reader_fseek(&r, DataSize - 1, SEEK_SET));
+  assert(reader_fgetc(&r) == data[DataSize - 1]);
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+
+  reader_destroy(&r);
+  reader_destroy(&mem);
+}
+
+static void test2(void)
+{
+  /* Random access to compressed data */
+  static unsigned char data[LongDataSize];
+  make_data(data, sizeof(data), 0);
+
+  _Optional void *buf = NULL;
+  Writer heap, w;
+  assert(writer_heap_init(&heap, &buf, 0));
+  assert(writer_gkey_init_from(&w, HistoryLog2, 0, &heap));
+  assert(writer_fwrite(data, sizeof(data), 1, &w) == 1);
+  assert(writer_destroy(&w) == LongDataSize);
+  long int const len = writer_destroy(&heap);
+  assert(len > 0);
+
+  Reader mem, gkey, r;
+  assert(reader_mem_init(&mem, (void *)buf, (size_t)len));
+  assert(reader_gkey_init_from(&gkey, HistoryLog2, &mem));
+  assert(reader_cache_init(&r, &gkey, LongPageSize,
+                           LongPageSize * NumPages));
+
+  /* Seeks concentrated in a few hot regions mostly hit the cache */
+  unsigned long seed = 1;
+  for (int i = 0; i < NumSeeks; ++i) {
+    seed = seed * 1103515245ul + 12345ul;
+    long int const region = (long)((seed >> 16) % NumPages);
+    long int const pos = (region * (LongDataSize / NumPages)) +
+                         (long)((seed >> 8) % LongPageSize) -
+                         (region * (LongDataSize / NumPages)) % LongPageSize;
+    assert(!reader_fseek(&r, pos, SEEK_SET));
+    assert(reader_fgetc(&r) == data[pos]);
+  }
+
+  ReaderCacheStats stats;
+  reader_cache_stats(&r, &stats);
+  assert(stats.hits + stats.misses == NumSeeks);
+  assert(stats.misses <= NumPages * 2);
+
+  reader_destroy(&r);
+  reader_destroy(&gkey);
+  reader_destroy(&mem);
+  free(buf);
+}
+
+static void test3(void)
+{
+  /* Page allocation fail recovery */
+  unsigned char data[DataSize] = {0};
+  Reader mem;
+  assert(reader_mem_init(&mem, data, sizeof(data)));
+
+  unsigned long limit;
+  for (limit = 0; limit < 8; ++limit) {
+    Reader r;
+    if (!reader_cache_init(&r, &mem, PageSize, PageSize * NumPages)) {
+      continue;
+    }
+
+    Fortify_SetNumAllocationsLimit(limit);
+    int const c = reader_fgetc(&r);
+    Fortify_SetNumAllocationsLimit(ULONG_MAX);
+
+    if (c == EOF) {
+      assert(reader_ferror(&r));
+    } else {
+      assert(c == 0);
+      assert(!reader_ferror(&r));
+    }
+    reader_destroy(&r);
+
+    if (c != EOF) {
+      break;
+    }
+  }
+  assert(limit != 8);
+
+  reader_destroy(&mem);
+}
+
+static void test4(void)
+{
+  /* Share decompressed files */
+  static unsigned char data[LongDataSize];
+  make_data(data, sizeof(data), 0);
+  char file_name[L_tmpnam];
+  tmpnam(file_name);
+  write_file(file_name, data, sizeof(data));
+
+  GKeyCacheStats before, after;
+  gkey_cache_stats(&before);
+  gkey_cache_set_budget(CacheBudget);
+
+  /* Both readers use the same cached data at once */
+  _Optional FILE *const f1 = fopen(file_name, "rb");
+  _Optional FILE *const f2 = fopen(file_name, "rb");
+  assert(f1 != NULL);
+  assert(f2 != NULL);
+  Reader r1, r2;
+  assert(reader_gkey_init_cached(&r1, HistoryLog2, &*f1));
+  assert(reader_gkey_init_cached(&r2, HistoryLog2, &*f2));
+  gkey_cache_stats(&after);
+  assert(after.misses == before.misses + 1);
+  assert(after.hits == before.hits + 1);
+  assert(after.used == LongDataSize);
+
+  /* Not shared with a different history size */
+  Reader r3;
+  assert(!fseek(&*f2, 0, SEEK_SET));
+  assert(reader_gkey_init_cached(&r3, HistoryLog2 + 1, &*f2));
+  gkey_cache_stats(&after);
+  assert(after.misses == before.misses + 2);
+  reader_destroy(&r3);
+
+  assert(reader_fgetc(&r1) == data[0]);
+  assert(!reader_fseek(&r2, LongDataSize - 1, SEEK_SET));
+  assert(reader_fgetc(&r2) == data[LongDataSize - 1]);
+  reader_destroy(&r1);
+  reader_destroy(&r2);
+  assert(!fclose(&*f1));
+  assert(!fclose(&*f2));
+
+  /* Still cached after all readers were destroyed */
+  read_cached(file_name, data, sizeof(data));
+  gkey_cache_stats(&after);
+  assert(after.hits == before.hits + 2);
+
+  gkey_cache_set_budget(0);
+  gkey_cache_stats(&after);
+  assert(after.used == 0);
+  remove(file_name);
+}
+
+static void test5(void)
+{
+  /* Modified files aren't stale */
+  static unsigned char data[LongDataSize];
+  char file_name[L_tmpnam];
+  tmpnam(file_name);
+  gkey_cache_set_budget(CacheBudget);
+
+  GKeyCacheStats before, after;
+  gkey_cache_stats(&before);
+
+  make_data(data, sizeof(data), 0);
+  write_file(file_name, data, sizeof(data));
+  read_cached(file_name, data, sizeof(data));
+
+  make_data(data, sizeof(data) / 2, 1);
+  write_file(file_name, data, sizeof(data) / 2);
+  read_cached(file_name, data, sizeof(data) / 2);
+
+  gkey_cache_stats(&after);
+  assert(after.misses == before.misses + 2);
+  assert(after.hits == before.hits);
+
+  gkey_cache_set_budget(0);
+  remove(file_name);
+}
+
+static void test6(void)
+{
+  /* Too big to cache */
+  static unsigned char data[LongDataSize];
+  make_data(data, sizeof(data), 0);
+  char file_name[L_tmpnam];
+  tmpnam(file_name);
+  write_file(file_name, data, sizeof(data));
+
+  gkey_cache_set_budget(LongDataSize - 1);
+  read_cached(file_name, data, sizeof(data));
+  read_cached(file_name, data, sizeof(data));
+
+  GKeyCacheStats stats;
+  gkey_cache_stats(&stats);
+  assert(stats.used == 0);
+
+  gkey_cache_set_budget(0);
+  remove(file_name);
+}
+
+static void test7(void)
+{
+  /* Cache each header form */
+  static unsigned char data[LongDataSize];
+  make_data(data, sizeof(data), 0);
+  char file_name[L_tmpnam];
+
+  enum { Classic, Extended, Members, EmptyFirstMember, NumForms };
+  for (int form = Classic; form < NumForms; ++form) {
+    tmpnam(file_name);
+    switch (form) {
+    case Classic:
+      write_file(file_name, data, sizeof(data));
+      break;
+
+    case Extended:
+      {
+        _Optional FILE *const f = fopen(file_name, "wb");
+        assert(f != NULL);
+        Writer w;
+        assert(writer_gkey_init(&w, HistoryLog2, 0, &*f));
+        writer_gkey_set_extended(&w, true);
+        assert(writer_fwrite(data, sizeof(data), 1, &w) == 1);
+        assert(writer_destroy(&w) == (long)sizeof(data));
+        assert(!fclose(&*f));
+      }
+      break;
+
+    case Members:
+      write_members(file_name, data, sizeof(data), sizeof(data) / 2);
+      break;
+
+    default:
+      write_members(file_name, data, sizeof(data), 0);
+      break;
+    }
+
+    GKeyCacheStats before, after;
+    gkey_cache_set_budget(CacheBudget);
+    gkey_cache_stats(&before);
+
+    read_cached(file_name, data, sizeof(data));
+    read_cached(file_name, data, sizeof(data));
+
+    gkey_cache_stats(&after);
+    assert(after.misses == before.misses + 1);
+    assert(after.hits == before.hits + 1);
+    assert(after.used == LongDataSize);
+
+    gkey_cache_set_budget(0);
+    remove(file_name);
+  }
+}
+
+static void test8(void)
+{
+  /* Members too big to cache */
+  static unsigned char data[LongDataSize];
+  make_data(data, sizeof(data), 0);
+  char file_name[L_tmpnam];
+  tmpnam(file_name);
+  write_members(file_name, data, sizeof(data), sizeof(data) / 2);
+
+  /* The first member fits but the whole stream doesn't */
+  gkey_cache_set_budget(LongDataSize - 1);
+  read_cached(file_name, data, sizeof(data));
+  read_cached(file_name, data, sizeof(data));
+
+  GKeyCacheStats stats;
+  gkey_cache_stats(&stats);
+  assert(stats.used == 0);
+
+  gkey_cache_set_budget(0);
+  remove(file_name);
+}
+
+void Cache_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Hits, misses and evictions", test1},
+    {"Random access to compressed data", test2},
+    {"Page allocation fail recovery", test3},
+    {"Share decompressed files", test4},
+    {"Modified files aren't stale", test5},
+    {"Too big to cache", test6},
+    {"Cache each header form", test7},
+    {"Members too big to cache", test8},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
@@ -0,0 +1,281 @@
+/*
+ * StreamLib test: Copying from a reader to a writer
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "ReaderGKey.h"
+#include "ReaderMem.h"
+#include "ReaderRaw.h"
+#include "StreamCopy.h"
+#include "WriterGKey.h"
+#include "WriterHeap.h"
+#include "WriterMem.h"
+#include "WriterRaw.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum {
+  HistoryLog2 = 9,
+  LongDataSize = 100000, /* greater than internal buffer size */
+  SmallBufferSize = 10,
+  Offset = 3,
+};
+
+static unsigned char data[LongDataSize], rdata[LongDataSize];
+
+static void make_data(void)
+{
+  for (size_t i = 0; i < LongDataSize; ++i) {
+    data[i] = (unsigned char)((i * i) % 251);
+  }
+}
+
+static void test1(void)
+{
+  /* Memory to memory */
+  make_data();
+  Reader r;
+  assert(reader_mem_init(&r, data, sizeof(data)));
+
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+
+  assert(stream_copy(&r, &w, -1) == LongDataSize);
+  assert(reader_ftell(&r) == LongDataSize);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+  assert(writer_ftell(&w) == LongDataSize);
+  assert(!writer_ferror(&w));
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == LongDataSize);
+  assert(buf != NULL);
+  assert(!memcmp((void *)buf, data, sizeof(data)));
+  free(buf);
+}
+
+static void test2(void)
+{
+  /* Copy part of the input */
+  make_data();
+  Reader r;
+  assert(reader_mem_init(&r, data, sizeof(data)));
+  assert(!reader_fseek(&r, Offset, SEEK_SET));
+
+  char buf[SmallBufferSize * 2];
+  Writer w;
+  assert(writer_mem_init(&w, buf, sizeof(buf)));
+  assert(!writer_fseek(&w, Offset, SEEK_SET));
+
+  assert(stream_copy(&r, &w, SmallBufferSize) == SmallBufferSize);
+  assert(reader_ftell(&r) == Offset + SmallBufferSize);
+  assert(!reader_feof(&r));
+  assert(writer_ftell(&w) == Offset + SmallBufferSize);
+  assert(!memcmp(buf + Offset, data + Offset, SmallBufferSize));
+
+  assert(stream_copy(&r, &w, 0) == 0);
+  assert(reader_ftell(&r) == Offset + SmallBufferSize);
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == Offset + SmallBufferSize);
+}
+
+static void test3(void)
+{
+  /* File to file */
+  make_data();
+  _Optional FILE *const in = tmpfile();
+  assert(in != NULL);
+  assert(fwrite(data, sizeof(data), 1, &*in) == 1);
+  assert(!fseek(&*in, 0, SEEK_SET));
+
+  _Optional FILE *const out = tmpfile();
+  assert(out != NULL);
+
+  Reader r;
+  reader_raw_init(&r, &*in);
+  Writer w;
+  writer_raw_init(&w, &*out);
+
+  /* Mix buffered and unbuffered I/O */
+  assert(reader_fgetc(&r) == data[0]);
+  assert(writer_fputc(data[0], &w) == data[0]);
+
+  assert(stream_copy(&r, &w, LongDataSize / 2) == LongDataSize / 2);
+  assert(reader_ftell(&r) == 1 + (LongDataSize / 2));
+  assert(writer_ftell(&w) == 1 + (LongDataSize / 2));
+
+  /* A pushed-back byte must be copied first */
+  assert(reader_fgetc(&r) == data[1 + (LongDataSize / 2)]);
+  assert(reader_ungetc(data[1 + (LongDataSize / 2)], &r) ==
+         data[1 + (LongDataSize / 2)]);
+
+  assert(stream_copy(&r, &w, -1) == (LongDataSize / 2) - 1);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+  assert(reader_fgetc(&r) == EOF);
+
+  /* The file position is still usable after copying */
+  assert(!reader_fseek(&r, Offset, SEEK_SET));
+  assert(reader_fgetc(&r) == data[Offset]);
+  assert(writer_fputc(data[0], &w) == data[0]);
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == LongDataSize + 1);
+
+  assert(!fseek(&*out, 0, SEEK_SET));
+  assert(fread(rdata, sizeof(rdata), 1, &*out) == 1);
+  assert(!memcmp(rdata, data, sizeof(data)));
+  assert(fgetc(&*out) == data[0]);
+  assert(fgetc(&*out) == EOF);
+
+  fclose(&*in);
+  fclose(&*out);
+}
+
+static void test4(void)
+{
+  /* Decompress to memory */
+  make_data();
+  _Optional void *comp_buf = NULL;
+  Writer comp_heap, comp;
+  assert(writer_heap_init(&comp_heap, &comp_buf, 0));
+  assert(writer_gkey_init_from(&comp, HistoryLog2, 0, &comp_heap));
+  assert(writer_fwrite(data, sizeof(data), 1, &comp) == 1);
+  assert(writer_destroy(&comp) == LongDataSize);
+  long int const comp_len = writer_destroy(&comp_heap);
+  assert(comp_len > 0);
+
+  Reader mem, r;
+  assert(reader_mem_init(&mem, (void *)comp_buf, (size_t)comp_len));
+  assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+  assert(stream_copy(&r, &w, -1) == LongDataSize);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+
+  /* Seeking back after decompressing directly to the caller's buffer */
+  assert(!reader_fseek(&r, Offset, SEEK_SET));
+  assert(reader_fgetc(&r) == data[Offset]);
+
+  reader_destroy(&r);
+  reader_destroy(&mem);
+  assert(writer_destroy(&w) == LongDataSize);
+  assert(buf != NULL);
+  assert(!memcmp((void *)buf, data, sizeof(data)));
+  free(buf);
+  free(comp_buf);
+}
+
+static void test5(void)
+{
+  /* Write error */
+  make_data();
+  Reader r;
+  assert(reader_mem_init(&r, data, sizeof(data)));
+
+  char buf[SmallBufferSize];
+  Writer w;
+  assert(writer_mem_init(&w, buf, sizeof(buf)));
+
+  assert(stream_copy(&r, &w, -1) == SmallBufferSize);
+  assert(writer_ferror(&w));
+  assert(reader_ftell(&r) == SmallBufferSize);
+  assert(!memcmp(buf, data, sizeof(buf)));
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == -1);
+}
+
+static void test6(void)
+{
+  /* Copy from empty input */
+  Reader r;
+  assert(reader_mem_init(&r, "", 0));
+
+  char buf[SmallBufferSize];
+  Writer w;
+  assert(writer_mem_init(&w, buf, sizeof(buf)));
+
+  assert(stream_copy(&r, &w, SmallBufferSize) == 0);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+  assert(!writer_ferror(&w));
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == 0);
+}
+
+static void test7(void)
+{
+  /* Copy from an empty file to the heap */
+  _Optional FILE *const in = tmpfile();
+  assert(in != NULL);
+  Reader r;
+  reader_raw_init(&r, &*in);
+
+  /* A raw reader can't peek so the heap writer's storage is prepared */
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+
+  assert(stream_copy(&r, &w, -1) == 0);
+  assert(reader_feof(&r));
+  assert(!writer_ferror(&w));
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == 0);
+  assert(buf == NULL);
+  fclose(&*in);
+}
+
+void Copy_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Memory to memory", test1},
+    {"Copy part of the input", test2},
+    {"File to file", test3},
+    {"Decompress to memory", test4},
+    {"Write error", test5},
+    {"Copy from empty input", test6},
+    {"Copy from an empty file to the heap", test7},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
@@ -0,0 +1,964 @@
+/*
+ * StreamLib test: Gordon Key compressed streams
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "Allocator.h"
+#include "GKeyBuf.h"
+#include "ReaderGKey.h"
+#include "ReaderMem.h"
+#include "ReaderSlc.h"
+#include "WriterGKey.h"
+#include "WriterHeap.h"
+
+/* Local headers */
+#include "Tests.h"
+
+#define TEST_STR "qwerty"
+
+enum {
+  HistoryLog2 = 9,
+  NumberOfStreams = 3,
+  LongDataSize = 1000, /* greater than internal buffer size */
+  HistorySize = 600,
+  ChunkSize = 100,
+  RetainThreshold = 64,
+  ExtHeaderSize = 16,
+};
+
+typedef struct {
+  unsigned char const *buf;
+  size_t len, pos;
+} ForwardData;
+
+static size_t forward_fread(void *ptr, size_t const size, Reader *const reader)
+{
+  /* Like a pipe, this can't seek backward */
+  ForwardData *const data = reader->data;
+  if ((unsigned long)reader->fpos != data->pos) {
+    reader->error = 1;
+    return 0;
+  }
+
+  size_t n = data->len - data->pos;
+  if (n > size) {
+    n = size;
+  } else {
+    reader->eof = 1;
+  }
+  memcpy(ptr, data->buf + data->pos, n);
+  data->pos += n;
+  return n;
+}
+
+static void forward_destroy(Reader *const reader)
+{
+  (void)reader;
+}
+
+static void forward_init(Reader *const reader, ForwardData *const data,
+                         void const *const buf, long int const len)
+{
+  *data = (ForwardData){.buf = buf, .len = (size_t)len, .pos = 0};
+  static ReaderFns const fns = {forward_fread, forward_destroy, NULL};
+  reader_internal_init(reader, &fns, data);
+}
+
+typedef struct {
+  unsigned char buf[LongDataSize * 2];
+  size_t len;
+} ForwardOutData;
+
+static size_t forward_fwrite(void const *ptr, size_t const size,
+                             Writer *const writer)
+{
+  /* Like a pipe, this can't seek backward */
+  ForwardOutData *const data = writer->data;
+  if ((unsigned long)writer->fpos != data->len ||
+      size > sizeof(data->buf) - data->len) {
+    writer->error = 1;
+    return 0;
+  }
+
+  memcpy(data->buf + data->len, ptr, size);
+  data->len += size;
+  return size;
+}
+
+static bool forward_term(Writer *const writer)
+{
+  (void)writer;
+  return true;
+}
+
+static void forward_out_init(Writer *const writer, ForwardOutData *const data)
+{
+  data->len = 0;
+  static WriterFns const fns = {forward_fwrite, forward_term, NULL};
+  writer_internal_init(writer, &fns, data);
+}
+
+static void make_data(unsigned char *const data, size_t const size,
+                      unsigned int const seed)
+{
+  for (size_t n = 0; n < size; ++n) {
+    data[n] = (unsigned char)((n * seed) ^ (n >> 3));
+  }
+}
+
+static size_t stream_size(size_t const i)
+{
+  return i == 0 ? strlen(TEST_STR) : LongDataSize / i;
+}
+
+static void test1(void)
+{
+  /* Reinit from (round trip) */
+  _Optional void *bufs[NumberOfStreams] = {NULL};
+  Writer heaps[NumberOfStreams];
+  long int lens[NumberOfStreams];
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  Writer w;
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    assert(writer_heap_init(&heaps[i], &bufs[i], 0));
+
+    if (i == 0) {
+      assert(writer_gkey_init_from(&w, HistoryLog2, 0, &heaps[i]));
+    } else {
+      assert(writer_gkey_reinit_from(&w, 0, &heaps[i]) ==
+             (long int)stream_size(i - 1));
+    }
+
+    make_data(data, stream_size(i), (unsigned int)i);
+    assert(writer_fwrite(data, stream_size(i), 1, &w) == 1);
+  }
+  assert(writer_destroy(&w) == (long int)stream_size(NumberOfStreams - 1));
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    lens[i] = writer_destroy(&heaps[i]);
+    assert(lens[i] > 0);
+  }
+
+  Reader r;
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    Reader mem;
+    assert(reader_mem_init(&mem, (void *)bufs[i], (size_t)lens[i]));
+
+    if (i == 0) {
+      assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+    } else {
+      reader_gkey_reinit_from(&r, &mem);
+    }
+    assert(reader_ftell(&r) == 0);
+    assert(!reader_feof(&r));
+
+    make_data(data, stream_size(i), (unsigned int)i);
+    assert(reader_fread(rdata, stream_size(i), 1, &r) == 1);
+    assert(!memcmp(data, rdata, stream_size(i)));
+    assert(reader_fgetc(&r) == EOF);
+    assert(reader_feof(&r));
+    assert(!reader_ferror(&r));
+
+    /* The previous backend is not used after reinitialization */
+    reader_destroy(&mem);
+    if (i == NumberOfStreams - 1) {
+      reader_destroy(&r);
+    } else {
+      assert(reader_mem_init(&mem, "", 0));
+      reader_gkey_reinit_from(&r, &mem);
+      reader_destroy(&mem);
+    }
+  }
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    free(bufs[i]);
+  }
+}
+
+static void test2(void)
+{
+  /* Reinit (round trip via files) */
+  _Optional FILE *files[NumberOfStreams];
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  Writer w;
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    files[i] = tmpfile();
+    assert(files[i] != NULL);
+
+    if (i == 0) {
+      assert(writer_gkey_init(&w, HistoryLog2, 0, &*files[i]));
+    } else {
+      assert(writer_gkey_reinit(&w, 0, &*files[i]) ==
+             (long int)stream_size(i - 1));
+    }
+
+    make_data(data, stream_size(i), (unsigned int)i);
+    assert(writer_fwrite(data, stream_size(i), 1, &w) == 1);
+  }
+  assert(writer_destroy(&w) == (long int)stream_size(NumberOfStreams - 1));
+
+  Reader r;
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    assert(files[i] != NULL);
+    rewind(&*files[i]);
+
+    if (i == 0) {
+      assert(reader_gkey_init(&r, HistoryLog2, &*files[i]));
+    } else {
+      reader_gkey_reinit(&r, &*files[i]);
+    }
+
+    make_data(data, stream_size(i), (unsigned int)i);
+    assert(reader_fread(rdata, stream_size(i), 1, &r) == 1);
+    assert(!memcmp(data, rdata, stream_size(i)));
+    assert(!reader_ferror(&r));
+  }
+  reader_destroy(&r);
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    assert(files[i] != NULL);
+    assert(!fclose(&*files[i]));
+  }
+}
+
+static void test3(void)
+{
+  /* Decompress members of a container in place */
+  _Optional void *bufs[NumberOfStreams] = {NULL};
+  long int lens[NumberOfStreams], offsets[NumberOfStreams], total = 0;
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    Writer heap, w;
+    assert(writer_heap_init(&heap, &bufs[i], 0));
+    assert(writer_gkey_init_from(&w, HistoryLog2, 0, &heap));
+    make_data(data, stream_size(i), (unsigned int)i);
+    assert(writer_fwrite(data, stream_size(i), 1, &w) == 1);
+    assert(writer_destroy(&w) == (long int)stream_size(i));
+    lens[i] = writer_destroy(&heap);
+    assert(lens[i] > 0);
+    offsets[i] = total;
+    total += lens[i];
+  }
+
+  _Optional char *const container = malloc((size_t)total);
+  assert(container != NULL);
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    memcpy(&*container + offsets[i], (void *)bufs[i], (size_t)lens[i]);
+    free(bufs[i]);
+  }
+
+  Reader parent;
+  assert(reader_mem_init(&parent, &*container, (size_t)total));
+
+  /* Read the members in reverse order to check that each slice seeks
+     its parent. */
+  for (size_t i = NumberOfStreams; i-- > 0;) {
+    Reader slice, r;
+    assert(reader_slice_init(&slice, &parent, offsets[i], lens[i]));
+    assert(reader_gkey_init_from(&r, HistoryLog2, &slice));
+
+    make_data(data, stream_size(i), (unsigned int)i);
+    assert(reader_fread(rdata, stream_size(i), 1, &r) == 1);
+    assert(!memcmp(data, rdata, stream_size(i)));
+    assert(reader_fgetc(&r) == EOF);
+    assert(reader_feof(&r));
+    assert(!reader_ferror(&r));
+
+    reader_destroy(&r);
+    reader_destroy(&slice);
+  }
+
+  reader_destroy(&parent);
+  free(container);
+}
+
+static long int compress(unsigned char const *const data, size_t const size,
+                         _Optional void **const buf)
+{
+  Writer heap, w;
+  assert(writer_heap_init(&heap, buf, 0));
+  assert(writer_gkey_init_from(&w, HistoryLog2, 0, &heap));
+  assert(writer_fwrite(data, size, 1, &w) == 1);
+  assert(writer_destroy(&w) == (long int)size);
+  long int const len = writer_destroy(&heap);
+  assert(len > 0);
+  return len;
+}
+
+static void test4(void)
+{
+  /* Seek backward within history */
+  _Optional void *buf = NULL;
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  make_data(data, sizeof(data), 3);
+  long int const len = compress(data, sizeof(data), &buf);
+
+  Reader mem, r;
+  assert(reader_mem_init(&mem, (void *)buf, (size_t)len));
+  assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+  assert(reader_gkey_set_history(&r, HistorySize));
+
+  /* One large read is decompressed straight into the caller's buffer */
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+  assert(!memcmp(data, rdata, sizeof(data)));
+  long int const in_pos = reader_ftell(&mem);
+
+  /* Seeks within the history don't read any more compressed data */
+  for (long int pos = LongDataSize - HistorySize; pos < LongDataSize;
+       pos += ChunkSize) {
+    assert(!reader_fseek(&r, pos, SEEK_SET));
+    memset(rdata, 0, sizeof(rdata));
+    assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+    assert(!memcmp(data + pos, rdata, ChunkSize));
+    assert(reader_ftell(&r) == pos + ChunkSize);
+    assert(reader_ftell(&mem) == in_pos);
+  }
+
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+
+  /* Seeking further back rewinds to the start */
+  assert(!reader_fseek(&r, 0, SEEK_SET));
+  assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+  assert(!memcmp(data, rdata, ChunkSize));
+
+  /* Read byte by byte, then back across the output buffer boundary */
+  for (long int pos = ChunkSize; pos < LongDataSize; ++pos) {
+    assert(reader_fgetc(&r) == data[pos]);
+  }
+  long int const pos = LongDataSize - HistorySize;
+  assert(!reader_fseek(&r, pos, SEEK_SET));
+  assert(reader_fread(rdata, LongDataSize - pos, 1, &r) == 1);
+  assert(!memcmp(data + pos, rdata, LongDataSize - pos));
+  assert(!reader_ferror(&r));
+
+  /* Disabling the history still allows seeking backward */
+  assert(reader_gkey_set_history(&r, 0));
+  assert(!reader_fseek(&r, pos, SEEK_SET));
+  assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+  assert(!memcmp(data + pos, rdata, ChunkSize));
+  assert(!reader_ferror(&r));
+
+  reader_destroy(&r);
+  reader_destroy(&mem);
+  free(buf);
+}
+
+static void test5(void)
+{
+  /* History is cleared on reinit */
+  _Optional void *bufs[2] = {NULL};
+  long int lens[2];
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+
+  for (size_t i = 0; i < ARRAY_SIZE(bufs); ++i) {
+    make_data(data, sizeof(data), (unsigned int)i + 5);
+    lens[i] = compress(data, sizeof(data), &bufs[i]);
+  }
+
+  Reader mem, r;
+  assert(reader_mem_init(&mem, (void *)bufs[0], (size_t)lens[0]));
+  assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+  assert(reader_gkey_set_history(&r, HistorySize));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+
+  reader_destroy(&mem);
+  assert(reader_mem_init(&mem, (void *)bufs[1], (size_t)lens[1]));
+  reader_gkey_reinit_from(&r, &mem);
+  assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+
+  /* Data before the output buffer must come from the second stream */
+  make_data(data, sizeof(data), 6);
+  for (long int pos = LongDataSize - ChunkSize; pos >= 0; pos -= ChunkSize) {
+    assert(!reader_fseek(&r, pos, SEEK_SET));
+    assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+    assert(!memcmp(data + pos, rdata, ChunkSize));
+  }
+  assert(!reader_ferror(&r));
+
+  reader_destroy(&r);
+  reader_destroy(&mem);
+  for (size_t i = 0; i < ARRAY_SIZE(bufs); ++i) {
+    free(bufs[i]);
+  }
+}
+
+static void test6(void)
+{
+  /* Rewind a non-seekable source */
+  static const struct {
+    size_t threshold;
+    long int limit;
+    bool can_rewind;
+  } cases[] = {
+    {0, 0, false},
+    {LongDataSize, LONG_MAX, true},
+    {RetainThreshold, LONG_MAX, true}, /* spills to a file */
+    {RetainThreshold, RetainThreshold, false},
+  };
+
+  _Optional void *buf = NULL;
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  make_data(data, sizeof(data), 7);
+  long int const len = compress(data, sizeof(data), &buf);
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); ++i) {
+    ForwardData fdata;
+    Reader in, r;
+    forward_init(&in, &fdata, (void *)buf, len);
+    assert(reader_gkey_init_from(&r, HistoryLog2, &in));
+    assert(reader_gkey_set_retain(&r, cases[i].threshold, cases[i].limit));
+
+    for (int pass = 0; pass < 2; ++pass) {
+      /* Read past the end of the output buffer, then seek back */
+      assert(reader_fread(rdata, ChunkSize, 3, &r) == 3);
+      assert(!memcmp(data, rdata, ChunkSize * 3));
+      assert(!reader_fseek(&r, ChunkSize, SEEK_SET));
+
+      if (!cases[i].can_rewind) {
+        assert(reader_fread(rdata, ChunkSize, 1, &r) == 0);
+        assert(reader_ferror(&r));
+        break;
+      }
+
+      assert(reader_fread(rdata, LongDataSize - ChunkSize, 1, &r) == 1);
+      assert(!memcmp(data + ChunkSize, rdata, LongDataSize - ChunkSize));
+      assert(reader_fgetc(&r) == EOF);
+      assert(!reader_ferror(&r));
+      assert(!reader_fseek(&r, 0, SEEK_SET));
+    }
+
+    reader_destroy(&r);
+    reader_destroy(&in);
+  }
+  free(buf);
+}
+
+static void test7(void)
+{
+  /* Decompress straight from memory */
+  _Optional void *buf = NULL;
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  make_data(data, sizeof(data), 9);
+  long int const len = compress(data, sizeof(data), &buf);
+
+  Reader r;
+  assert(reader_gkey_init_mem(&r, HistoryLog2, (void *)buf, (size_t)len));
+  assert(reader_ftell(&r) == 0);
+
+  for (long int pos = 0; pos < LongDataSize; pos += ChunkSize) {
+    assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+    assert(!memcmp(data + pos, rdata, ChunkSize));
+  }
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+
+  /* Seeking backward decompresses the array again */
+  assert(!reader_fseek(&r, ChunkSize, SEEK_SET));
+  assert(reader_fread(rdata, LongDataSize - ChunkSize, 1, &r) == 1);
+  assert(!memcmp(data + ChunkSize, rdata, LongDataSize - ChunkSize));
+  assert(!reader_ferror(&r));
+  reader_destroy(&r);
+
+  /* Truncated input is detected */
+  assert(reader_gkey_init_mem(&r, HistoryLog2, (void *)buf,
+                              (size_t)len / 2));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 0);
+  assert(reader_ferror(&r));
+  reader_destroy(&r);
+
+  assert(reader_gkey_init_mem(&r, HistoryLog2, (void *)buf, 2));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_ferror(&r));
+  reader_destroy(&r);
+
+  free(buf);
+}
+
+static void test8(void)
+{
+  /* One-shot compress and decompress */
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  unsigned char cdata[LongDataSize * 2];
+
+  assert(gkey_compress_bound(0) == sizeof(int32_t));
+  assert(gkey_compress_bound(1) == sizeof(int32_t) + 2);
+  assert(gkey_compress_bound(8) == sizeof(int32_t) + 9);
+  assert(gkey_compress_bound(SIZE_MAX) == 0);
+
+  for (size_t i = 0; i < NumberOfStreams; ++i) {
+    size_t const size = stream_size(i);
+    make_data(data, size, (unsigned int)i);
+
+    size_t const bound = gkey_compress_bound(size);
+    assert(bound <= sizeof(cdata));
+    long int const clen = gkey_compress_buffer(HistoryLog2, data, size,
+                                               cdata, bound);
+    assert(clen > 0);
+    assert((unsigned long)clen <= bound);
+
+    /* The output is the same as that of the streaming writer */
+    _Optional void *buf = NULL;
+    long int const len = compress(data, size, &buf);
+    assert(len == clen);
+    assert(!memcmp((void *)buf, cdata, (size_t)clen));
+    free(buf);
+
+    assert(gkey_decompressed_size(cdata, (size_t)clen) == (long)size);
+    memset(rdata, 0, sizeof(rdata));
+    assert(gkey_decompress_buffer(HistoryLog2, cdata, (size_t)clen, rdata,
+                                  sizeof(rdata)) == (long)size);
+    assert(!memcmp(data, rdata, size));
+
+    size_t out_size;
+    _Optional void *const out =
+      gkey_decompress_alloc(HistoryLog2, cdata, (size_t)clen, &out_size);
+    assert(out != NULL);
+    assert(out_size == size);
+    assert(!memcmp(data, (void *)out, size));
+    free(out);
+
+    /* Too little space */
+    assert(gkey_compress_buffer(HistoryLog2, data, size, cdata,
+                                sizeof(int32_t)) == -1);
+    assert(gkey_decompress_buffer(HistoryLog2, cdata, (size_t)clen, rdata,
+                                  size - 1) == -1);
+  }
+}
+
+static void test9(void)
+{
+  /* One-shot decompress bad input */
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  unsigned char cdata[LongDataSize * 2];
+  make_data(data, sizeof(data), 11);
+
+  long int const clen = gkey_compress_buffer(HistoryLog2, data, sizeof(data),
+                                             cdata, sizeof(cdata));
+  assert(clen > 0);
+
+  /* Truncated header or data */
+  assert(gkey_decompressed_size(cdata, 2) == -1);
+  assert(gkey_decompress_buffer(HistoryLog2, cdata, 2, rdata,
+                                sizeof(rdata)) == -1);
+  assert(gkey_decompress_buffer(HistoryLog2, cdata, (size_t)clen / 2, rdata,
+                                sizeof(rdata)) == -1);
+
+  size_t out_size = 1;
+  assert(gkey_decompress_alloc(HistoryLog2, cdata, (size_t)clen / 2,
+                               &out_size) == NULL);
+  assert(out_size == 0);
+
+  /* Negative size */
+  static unsigned char const bad_hdr[] = {0, 0, 0, 0x80};
+  assert(gkey_decompressed_size(bad_hdr, sizeof(bad_hdr)) == -1);
+
+  /* Empty */
+  static unsigned char const empty[] = {0, 0, 0, 0};
+  assert(gkey_decompressed_size(empty, sizeof(empty)) == 0);
+  _Optional void *const out =
+    gkey_decompress_alloc(HistoryLog2, empty, sizeof(empty), &out_size);
+  assert(out != NULL);
+  assert(out_size == 0);
+  free(out);
+}
+
+static void test10(void)
+{
+  /* Compress to a non-seekable destination */
+  static const struct {
+    bool exact;
+    size_t threshold;
+    long int limit, min_size, size;
+    bool ok;
+  } cases[] = {
+    {false, 0, 0, 0, LongDataSize, false},
+    {false, 0, 0, LongDataSize, ChunkSize, true}, /* padded */
+    {true, 0, 0, LongDataSize, LongDataSize, true},
+    {true, 0, 0, ChunkSize, LongDataSize, false},
+    {true, LongDataSize, LONG_MAX, 0, LongDataSize, false},
+    {false, LongDataSize, LONG_MAX, 0, LongDataSize, true},
+    {false, RetainThreshold, LONG_MAX, 0, LongDataSize, true}, /* spills */
+    {false, RetainThreshold, LONG_MAX, LongDataSize, ChunkSize, true},
+    {false, RetainThreshold, RetainThreshold, 0, LongDataSize, false},
+    {false, RetainThreshold, RetainThreshold, LongDataSize, ChunkSize, true},
+  };
+
+  unsigned char data[LongDataSize];
+  make_data(data, sizeof(data), 13);
+  static ForwardOutData fdata;
+
+  for (size_t i = 0; i < ARRAY_SIZE(cases); ++i) {
+    Writer out, w;
+    forward_out_init(&out, &fdata);
+    assert(writer_gkey_init_from(&w, HistoryLog2, cases[i].min_size, &out));
+    writer_gkey_set_exact(&w, cases[i].exact);
+    assert(writer_gkey_set_spool(&w, cases[i].threshold, cases[i].limit));
+
+    size_t const size = (size_t)cases[i].size;
+    size_t const n = writer_fwrite(data, 1, size, &w);
+    long int const len = writer_destroy(&w);
+    long int const out_len = writer_destroy(&out);
+
+    if (!cases[i].ok) {
+      assert(len == -1);
+      continue;
+    }
+
+    assert(n == size);
+    assert(len == cases[i].size);
+    assert(out_len == (long int)fdata.len);
+    long int const expected =
+      cases[i].size > cases[i].min_size ? cases[i].size : cases[i].min_size;
+
+    size_t out_size;
+    _Optional unsigned char *const rdata =
+      gkey_decompress_alloc(HistoryLog2, fdata.buf, fdata.len, &out_size);
+    assert(rdata != NULL);
+    assert(out_size == (size_t)expected);
+    assert(!memcmp(data, &*rdata, size));
+    for (size_t j = size; j < out_size; ++j) {
+      assert(rdata[j] == 0);
+    }
+    free(rdata);
+  }
+}
+
+static void test11(void)
+{
+  /* Extended header */
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  make_data(data, sizeof(data), 17);
+
+  /* The header is rewritten in place because min_size is too small */
+  _Optional void *buf = NULL;
+  Writer heap, w;
+  assert(writer_heap_init(&heap, &buf, 0));
+  assert(writer_gkey_init_from(&w, HistoryLog2, 0, &heap));
+  writer_gkey_set_extended(&w, true);
+  assert(writer_fwrite(data, sizeof(data), 1, &w) == 1);
+  assert(writer_destroy(&w) == LongDataSize);
+  long int const len = writer_destroy(&heap);
+  assert(len > ExtHeaderSize);
+
+  static unsigned char const hdr[ExtHeaderSize] = {
+    0xff, 0xff, 0xff, 0xff, 1, 0, 0, 0,
+    LongDataSize & 0xff, LongDataSize >> 8, 0, 0, 0, 0, 0, 0};
+  unsigned char *const cdata = (void *)buf;
+  assert(!memcmp(cdata, hdr, sizeof(hdr)));
+  assert(gkey_decompressed_size(cdata, (size_t)len) == LongDataSize);
+
+  /* Read, then rewind to just after the header */
+  Reader mem, r;
+  assert(reader_mem_init(&mem, cdata, (size_t)len));
+  assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+  for (int pass = 0; pass < 2; ++pass) {
+    assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+    assert(!memcmp(data, rdata, sizeof(data)));
+    assert(reader_fgetc(&r) == EOF);
+    assert(!reader_fseek(&r, 0, SEEK_SET));
+  }
+  reader_destroy(&r);
+  reader_destroy(&mem);
+
+  assert(reader_gkey_init_mem(&r, HistoryLog2, cdata, (size_t)len));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+  assert(!memcmp(data, rdata, sizeof(data)));
+  reader_destroy(&r);
+
+  size_t out_size;
+  _Optional void *const out =
+    gkey_decompress_alloc(HistoryLog2, cdata, (size_t)len, &out_size);
+  assert(out != NULL);
+  assert(out_size == LongDataSize);
+  assert(!memcmp(data, (void *)out, out_size));
+  free(out);
+
+  /* Truncated extended header */
+  assert(gkey_decompressed_size(cdata, ExtHeaderSize - 1) == -1);
+
+  /* Unknown version or flags */
+  cdata[6] = 1;
+  assert(gkey_decompressed_size(cdata, (size_t)len) == -1);
+  assert(reader_mem_init(&mem, cdata, (size_t)len));
+  assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+  assert(reader_fread(rdata, 1, 1, &r) == 0);
+  assert(reader_ferror(&r));
+  reader_destroy(&r);
+  reader_destroy(&mem);
+  free(buf);
+
+  /* Sizes beyond the classic header's range */
+  if (LONG_MAX > INT32_MAX) {
+    static unsigned char const big[ExtHeaderSize] = {
+      0xff, 0xff, 0xff, 0xff, 1, 0, 0, 0, 5, 0, 0, 0, 1, 0, 0, 0};
+    assert(gkey_decompressed_size(big, sizeof(big)) ==
+           (long)(((uint64_t)1 << 32) + 5));
+  }
+}
+
+static void test12(void)
+{
+  /* Append members to a file */
+  enum { NumMembers = 4, Total = LongDataSize * 2 + ChunkSize };
+  static size_t const sizes[NumMembers] = {LongDataSize, ChunkSize, 0,
+                                           LongDataSize};
+  unsigned char data[Total], rdata[Total];
+  make_data(data, sizeof(data), 19);
+
+  FILE *const f = tmpfile();
+  assert(f != NULL);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < NumMembers; ++i) {
+    Writer w;
+    assert(writer_gkey_append(&w, HistoryLog2, f));
+    assert(writer_fwrite(data + offset, 1, sizes[i], &w) == sizes[i]);
+    assert(writer_destroy(&w) == (long int)sizes[i]);
+    offset += sizes[i];
+  }
+  assert(offset == Total);
+
+  /* Read the members as one stream */
+  rewind(f);
+  Reader r;
+  assert(reader_gkey_init(&r, HistoryLog2, f));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+  assert(!memcmp(data, rdata, sizeof(data)));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+
+  /* Seek backward across members, then forward across members */
+  long int const pos = LongDataSize - ChunkSize;
+  assert(!reader_fseek(&r, pos, SEEK_SET));
+  assert(reader_fread(rdata, ChunkSize * 2, 1, &r) == 1);
+  assert(!memcmp(data + pos, rdata, ChunkSize * 2));
+  assert(!reader_fseek(&r, Total - ChunkSize, SEEK_SET));
+  assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+  assert(!memcmp(data + Total - ChunkSize, rdata, ChunkSize));
+  assert(!reader_ferror(&r));
+
+  assert(!reader_fseek(&r, Total + 1, SEEK_SET));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_ferror(&r));
+  reader_destroy(&r);
+
+  /* Read straight from memory, or from a non-seekable source */
+  long int const len = ftell(f);
+  assert(len > 0);
+  static unsigned char cdata[Total * 2];
+  assert((size_t)len <= sizeof(cdata));
+  rewind(f);
+  assert(fread(cdata, (size_t)len, 1, f) == 1);
+  fclose(f);
+
+  assert(reader_gkey_init_mem(&r, HistoryLog2, cdata, (size_t)len));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+  assert(!memcmp(data, rdata, sizeof(data)));
+  assert(reader_fgetc(&r) == EOF);
+  assert(!reader_fseek(&r, ChunkSize, SEEK_SET));
+  assert(reader_fread(rdata, ChunkSize, 1, &r) == 1);
+  assert(!memcmp(data + ChunkSize, rdata, ChunkSize));
+  reader_destroy(&r);
+
+  ForwardData fdata;
+  Reader in;
+  forward_init(&in, &fdata, cdata, len);
+  assert(reader_gkey_init_from(&r, HistoryLog2, &in));
+  for (size_t i = 0; i < Total; ++i) {
+    assert(reader_fgetc(&r) == data[i]);
+  }
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+  reader_destroy(&r);
+  reader_destroy(&in);
+}
+
+static void test13(void)
+{
+  /* Append spooled members to a non-seekable destination */
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  make_data(data, sizeof(data), 23);
+
+  static ForwardOutData fdata;
+  Writer out, w;
+  forward_out_init(&out, &fdata);
+
+  /* Spooling is needed for the compressed size even if the input size
+     is exact */
+  assert(writer_gkey_init_from(&w, HistoryLog2, ChunkSize, &out));
+  writer_gkey_set_members(&w, true);
+  writer_gkey_set_exact(&w, true);
+  assert(writer_gkey_set_spool(&w, RetainThreshold, LONG_MAX));
+  assert(writer_fwrite(data, ChunkSize, 1, &w) == 1);
+  assert(writer_destroy(&w) == ChunkSize);
+
+  assert(writer_gkey_append_from(&w, HistoryLog2, &out));
+  assert(writer_gkey_set_spool(&w, RetainThreshold, LONG_MAX));
+  assert(writer_fwrite(data + ChunkSize, LongDataSize - ChunkSize, 1, &w) ==
+         1);
+  assert(writer_destroy(&w) == LongDataSize - ChunkSize);
+
+  /* Without spooling, the header can't be corrected */
+  assert(writer_gkey_append_from(&w, HistoryLog2, &out));
+  assert(writer_fputc('x', &w) == 'x');
+  assert(writer_destroy(&w) == -1);
+  assert(writer_destroy(&out) == -1);
+
+  Reader r;
+  assert(reader_gkey_init_mem(&r, HistoryLog2, fdata.buf, fdata.len));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+  assert(!memcmp(data, rdata, sizeof(data)));
+
+  /* The last member's header wasn't corrected */
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_ferror(&r));
+  reader_destroy(&r);
+}
+
+static void test14(void)
+{
+  /* Append members to a heap writer */
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+  make_data(data, sizeof(data), 29);
+
+  _Optional void *buf = NULL;
+  Writer heap, w;
+  assert(writer_heap_init(&heap, &buf, 0));
+
+  assert(writer_gkey_append_from(&w, HistoryLog2, &heap));
+  assert(writer_fwrite(data, ChunkSize, 1, &w) == 1);
+  assert(writer_destroy(&w) == ChunkSize);
+  long int const len = writer_ftell(&heap);
+  assert(len > ExtHeaderSize);
+
+  assert(writer_gkey_append_from(&w, HistoryLog2, &heap));
+  assert(writer_fwrite(data + ChunkSize, LongDataSize - ChunkSize, 1, &w) ==
+         1);
+  assert(writer_destroy(&w) == LongDataSize - ChunkSize);
+  assert(writer_ftell(&heap) > len);
+
+  long int const total = writer_destroy(&heap);
+  assert(total > len);
+
+  Reader r;
+  assert(reader_gkey_init_mem(&r, HistoryLog2, (void *)buf, (size_t)total));
+  assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+  assert(!memcmp(data, rdata, sizeof(data)));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+  reader_destroy(&r);
+  free(buf);
+}
+
+static _Optional void *count_alloc(size_t const size, void *const ctx)
+{
+  unsigned long *const count = ctx;
+  ++*count;
+  return malloc(size);
+}
+
+static _Optional void *count_realloc(_Optional void *const ptr,
+                                     size_t const size, void *const ctx)
+{
+  unsigned long *const count = ctx;
+  ++*count;
+  return realloc((void *)ptr, size);
+}
+
+static void count_free(_Optional void *const ptr, void *const ctx)
+{
+  unsigned long *const count = ctx;
+  if (ptr) {
+    ++*count;
+  }
+  free(ptr);
+}
+
+static void test15(void)
+{
+  /* One-shot decompress ignores allocator hooks */
+  unsigned char data[LongDataSize], cdata[LongDataSize * 2];
+  make_data(data, sizeof(data), 31);
+  long int const clen = gkey_compress_buffer(HistoryLog2, data, sizeof(data),
+                                             cdata, sizeof(cdata));
+  assert(clen > 0);
+
+  unsigned long count = 0;
+  StreamAllocator const alloc = {count_alloc, count_realloc, count_free,
+                                 &count};
+  stream_set_allocator(&alloc);
+
+  size_t out_size;
+  _Optional void *const out =
+    gkey_decompress_alloc(HistoryLog2, cdata, (size_t)clen, &out_size);
+
+  stream_set_allocator(NULL);
+  assert(count == 0);
+  assert(out != NULL);
+  assert(out_size == LongDataSize);
+  assert(!memcmp(data, (void *)out, out_size));
+  free(out);
+}
+
+void GKey_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Reinit from", test1},
+    {"Reinit", test2},
+    {"Decompress members of a container in place", test3},
+    {"Seek backward within history", test4},
+    {"History is cleared on reinit", test5},
+    {"Rewind a non-seekable source", test6},
+    {"Decompress straight from memory", test7},
+    {"One-shot compress and decompress", test8},
+    {"One-shot decompress bad input", test9},
+    {"Compress to a non-seekable destination", test10},
+    {"Extended header", test11},
+    {"Append members to a file", test12},
+    {"Append spooled members to a non-seekable destination", test13},
+    {"Append members to a heap writer", test14},
+    {"One-shot decompress ignores allocator hooks", test15},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
@@ -0,0 +1,168 @@
+/*
+ * StreamLib test: Reallocating memory buffer handoff
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "ReaderHeap.h"
+#include "WriterHeap.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum {
+  LongDataSize = 1000,
+};
+
+static void test1(void)
+{
+  /* Read while writing */
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+
+  Reader r;
+  reader_heap_init(&r, &w);
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  assert(!reader_ferror(&r));
+
+  for (int i = 0; i < LongDataSize; ++i) {
+    unsigned char const c = (unsigned char)i;
+    assert(writer_fputc(c, &w) == c);
+
+    /* The buffer may move but previously-read data is still visible */
+    assert(!reader_fseek(&r, i, SEEK_SET));
+    assert(reader_fgetc(&r) == c);
+    assert(reader_fgetc(&r) == EOF);
+    assert(reader_feof(&r));
+  }
+
+  /* Seeking beyond the written data fails on reading */
+  assert(!reader_fseek(&r, LongDataSize + 1, SEEK_SET));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_ferror(&r));
+
+  reader_destroy(&r);
+  assert(writer_destroy(&w) == LongDataSize);
+  free(buf);
+}
+
+static void test2(void)
+{
+  /* Hand over to reader */
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+
+  for (int i = 0; i < LongDataSize; ++i) {
+    unsigned char const c = (unsigned char)i;
+    assert(writer_fputc(c, &w) == c);
+  }
+  _Optional void *const old_buf = buf;
+  assert(writer_heap_buffer(&w) == buf);
+  assert(writer_heap_length(&w) == LongDataSize);
+
+  /* Seeking doesn't change the extent of valid data */
+  assert(!writer_fseek(&w, LongDataSize * 4, SEEK_SET));
+  assert(writer_heap_length(&w) == LongDataSize);
+  assert(!writer_fseek(&w, 1, SEEK_SET));
+  assert(writer_heap_length(&w) == LongDataSize);
+
+  Reader r;
+  assert(writer_heap_to_reader(&w, &r) == LongDataSize);
+
+  /* The buffer was neither moved nor truncated */
+  assert(buf == old_buf);
+
+  for (int i = 0; i < LongDataSize; ++i) {
+    assert(reader_fgetc(&r) == (unsigned char)i);
+  }
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  reader_destroy(&r);
+  free(buf);
+}
+
+static void test3(void)
+{
+  /* Hand over empty buffer */
+  _Optional void *buf = NULL;
+  Writer w;
+  assert(writer_heap_init(&w, &buf, 0));
+  assert(writer_heap_buffer(&w) == NULL);
+
+  Reader r;
+  assert(writer_heap_to_reader(&w, &r) == 0);
+  assert(buf == NULL);
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+  reader_destroy(&r);
+}
+
+static void test4(void)
+{
+  /* Hand over fail recovery */
+  unsigned long limit;
+  for (limit = 0; limit < 8; ++limit) {
+    _Optional void *buf = NULL;
+    Writer w;
+    assert(writer_heap_init(&w, &buf, 0));
+    assert(writer_fputc('x', &w) == 'x');
+
+    Reader r;
+    Fortify_SetNumAllocationsLimit(limit);
+    long int const len = writer_heap_to_reader(&w, &r);
+    Fortify_SetNumAllocationsLimit(ULONG_MAX);
+
+    free(buf);
+    if (len >= 0) {
+      assert(len == 1);
+      reader_destroy(&r);
+      break;
+    }
+  }
+  assert(limit != 8);
+}
+
+void Heap_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Read while writing", test1},
+    {"Hand over to reader", test2},
+    {"Hand over empty buffer", test3},
+    {"Hand over fail recovery", test4},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
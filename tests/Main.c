@@ -35,6 +35,16 @@ int main(int argc, char *argv[])
     {"ReaderNull", ReaderNull_tests},
     {"Writer", Writer_tests},
     {"WriterGKC", WriterGKC_tests},
+    {"Alloc", Alloc_tests},
+    {"GKey", GKey_tests},
+    {"Heap", Heap_tests},
+    {"Tee", Tee_tests},
+    {"Copy", Copy_tests},
+    {"Cache", Cache_tests},
+    {"Batch", Batch_tests},
+#ifdef STREAM_PIPE
+    {"Pipe", Pipe_tests},
+#endif
   };
 
   NOT_USED(argc);
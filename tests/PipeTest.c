@@ -0,0 +1,294 @@
+/*
+ * StreamLib test: Single-producer/single-consumer memory pipe
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* POSIX headers */
+#include <pthread.h>
+
+/* StreamLib headers */
+#include "ReaderGKey.h"
+#include "ReaderPipe.h"
+#include "WriterGKey.h"
+#include "WriterPipe.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum {
+  HistoryLog2 = 9,
+  Capacity = 16,
+  LongDataSize = 100000, /* much greater than pipe capacity */
+  BlockSize = 37,
+};
+
+static unsigned char data_byte(size_t const n)
+{
+  return (unsigned char)((n * 7) ^ (n >> 5));
+}
+
+static void *produce(void *const arg)
+{
+  Pipe *const pipe = arg;
+  Writer w;
+  assert(writer_pipe_init(&w, pipe, true));
+
+  unsigned char block[BlockSize];
+  for (size_t n = 0; n < LongDataSize; n += BlockSize) {
+    size_t const len = LongDataSize - n < BlockSize ?
+                       LongDataSize - n : BlockSize;
+    for (size_t i = 0; i < len; ++i) {
+      block[i] = data_byte(n + i);
+    }
+    assert(writer_fwrite(block, len, 1, &w) == 1);
+  }
+  assert(writer_destroy(&w) == LongDataSize);
+  return NULL;
+}
+
+static void *produce_gkey(void *const arg)
+{
+  Pipe *const pipe = arg;
+  Writer raw, w;
+  assert(writer_pipe_init(&raw, pipe, true));
+  assert(writer_gkey_init_from(&w, HistoryLog2, LongDataSize, &raw));
+
+  for (size_t n = 0; n < LongDataSize; ++n) {
+    assert(writer_fputc(data_byte(n), &w) == data_byte(n));
+  }
+  assert(writer_destroy(&w) == LongDataSize);
+  assert(writer_destroy(&raw) > 0);
+  return NULL;
+}
+
+static void consume(Reader *const r)
+{
+  unsigned char block[BlockSize];
+  size_t total = 0;
+
+  for (;;) {
+    size_t const n = reader_fread(block, 1, sizeof(block), r);
+    for (size_t i = 0; i < n; ++i) {
+      assert(block[i] == data_byte(total + i));
+    }
+    total += n;
+    if (n < sizeof(block)) {
+      break;
+    }
+  }
+
+  assert(total == LongDataSize);
+  assert(reader_feof(r));
+  assert(!reader_ferror(r));
+}
+
+static void test1(void)
+{
+  /* Transfer between threads */
+  _Optional Pipe *const pipe = pipe_make(Capacity);
+  assert(pipe != NULL);
+
+  pthread_t thread;
+  assert(!pthread_create(&thread, NULL, produce, &*pipe));
+
+  Reader r;
+  assert(reader_pipe_init(&r, &*pipe, true));
+  consume(&r);
+  assert(pipe_eof(&*pipe));
+  reader_destroy(&r);
+
+  assert(!pthread_join(thread, NULL));
+  pipe_destroy(pipe);
+}
+
+static void test2(void)
+{
+  /* Compressed transfer between threads */
+  _Optional Pipe *const pipe = pipe_make(Capacity);
+  assert(pipe != NULL);
+
+  pthread_t thread;
+  assert(!pthread_create(&thread, NULL, produce_gkey, &*pipe));
+
+  Reader raw, r;
+  assert(reader_pipe_init(&raw, &*pipe, true));
+  assert(reader_gkey_init_from(&r, HistoryLog2, &raw));
+  consume(&r);
+  reader_destroy(&r);
+  reader_destroy(&raw);
+
+  assert(!pthread_join(thread, NULL));
+  pipe_destroy(pipe);
+}
+
+static void test3(void)
+{
+  /* Non-blocking */
+  _Optional Pipe *const pipe = pipe_make(Capacity);
+  assert(pipe != NULL);
+  assert(pipe_space(&*pipe) == Capacity);
+  assert(pipe_avail(&*pipe) == 0);
+
+  Writer w;
+  assert(writer_pipe_init(&w, &*pipe, false));
+  Reader r;
+  assert(reader_pipe_init(&r, &*pipe, false));
+
+  for (int i = 0; i < Capacity; ++i) {
+    assert(writer_fputc(i, &w) == i);
+  }
+  assert(pipe_space(&*pipe) == 0);
+  assert(pipe_avail(&*pipe) == Capacity);
+
+  /* Skipped bytes are discarded */
+  assert(!reader_fseek(&r, 1, SEEK_SET));
+  for (int i = 1; i < Capacity; ++i) {
+    assert(reader_fgetc(&r) == i);
+  }
+
+  /* Lack of data isn't end-of-file until the writer is destroyed */
+  assert(reader_fgetc(&r) == EOF);
+  assert(!reader_feof(&r));
+  assert(!reader_ferror(&r));
+  assert(!pipe_eof(&*pipe));
+
+  assert(writer_fputc(Capacity, &w) == Capacity);
+  assert(reader_fgetc(&r) == Capacity);
+
+  assert(writer_destroy(&w) == Capacity + 1);
+  assert(pipe_eof(&*pipe));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_feof(&r));
+
+  reader_destroy(&r);
+  pipe_destroy(pipe);
+}
+
+static void test4(void)
+{
+  /* Write to full pipe is short when non-blocking */
+  _Optional Pipe *const pipe = pipe_make(Capacity);
+  assert(pipe != NULL);
+
+  Writer w;
+  assert(writer_pipe_init(&w, &*pipe, false));
+  Reader r;
+  assert(reader_pipe_init(&r, &*pipe, false));
+
+  static unsigned char data[Capacity + 1];
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = (unsigned char)i;
+  }
+  assert(writer_fwrite(data, 1, sizeof(data), &w) == Capacity);
+  assert(!writer_ferror(&w));
+  assert(writer_ftell(&w) == Capacity);
+  assert(writer_fputc(data[Capacity], &w) == EOF);
+  assert(!writer_ferror(&w));
+
+  /* The rest can be written once there is room */
+  assert(reader_fgetc(&r) == data[0]);
+  assert(writer_fputc(data[Capacity], &w) == data[Capacity]);
+  for (size_t i = 1; i < sizeof(data); ++i) {
+    assert(reader_fgetc(&r) == data[i]);
+  }
+
+  /* A write after the reader is destroyed fails */
+  reader_destroy(&r);
+  assert(writer_fputc(0, &w) == EOF);
+  assert(writer_ferror(&w));
+  assert(writer_destroy(&w) == -1);
+
+  pipe_destroy(pipe);
+}
+
+static void test5(void)
+{
+  /* Write fails after reader is destroyed */
+  _Optional Pipe *const pipe = pipe_make(Capacity);
+  assert(pipe != NULL);
+
+  Reader r;
+  assert(reader_pipe_init(&r, &*pipe, true));
+  reader_destroy(&r);
+
+  Writer w;
+  assert(writer_pipe_init(&w, &*pipe, true));
+
+  static unsigned char const zeros[Capacity * 2];
+  assert(writer_fwrite(zeros, sizeof(zeros), 1, &w) == 0);
+  assert(writer_ferror(&w));
+  assert(writer_destroy(&w) == -1);
+
+  pipe_destroy(pipe);
+}
+
+static void test6(void)
+{
+  /* Seek backward fails */
+  _Optional Pipe *const pipe = pipe_make(Capacity);
+  assert(pipe != NULL);
+
+  Writer w;
+  assert(writer_pipe_init(&w, &*pipe, true));
+  Reader r;
+  assert(reader_pipe_init(&r, &*pipe, true));
+
+  assert(writer_fputc('a', &w) == 'a');
+  assert(reader_fgetc(&r) == 'a');
+
+  assert(!writer_fseek(&w, 0, SEEK_SET));
+  assert(writer_fputc('b', &w) == EOF);
+  assert(writer_ferror(&w));
+
+  assert(!reader_fseek(&r, 0, SEEK_SET));
+  assert(reader_fgetc(&r) == EOF);
+  assert(reader_ferror(&r));
+
+  assert(writer_destroy(&w) == -1);
+  reader_destroy(&r);
+  pipe_destroy(pipe);
+}
+
+void Pipe_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Transfer between threads", test1},
+    {"Compressed transfer between threads", test2},
+    {"Non-blocking", test3},
+    {"Write to full pipe is short when non-blocking", test4},
+    {"Write fails after reader is destroyed", test5},
+    {"Seek backward fails", test6},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
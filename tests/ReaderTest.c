@@ -33,6 +33,13 @@
 #include "ReaderFlex.h"
 #endif
 #include "ReaderMem.h"
+#include "ReaderChnk.h"
+#include "ReaderSegs.h"
+#include "ReaderSlc.h"
+#include "ReaderCat.h"
+#include "ReaderBuf.h"
+#include "ReaderCach.h"
+#include "ReaderSpl.h"
 
 /* Local headers */
 #include "Tests.h"
@@ -46,7 +53,13 @@ enum {
   BufferSize = 512,
   LongDataSize = 320, /* greater than internal buffer size */
   Marker = 56,
-  Offset = 3
+  Offset = 3,
+  ChunkSize = 7,
+  SpillThreshold = 16,
+  SliceOffset = 5, /* amount of padding around slice data */
+  MaxOpenSources = 2,
+  ReadBufferSize = 5,
+  CachePages = 3,
 };
 
 typedef enum {
@@ -56,6 +69,14 @@ typedef enum {
   READERTYPE_FLEX,
 #endif
   READERTYPE_MEM,
+  READERTYPE_CHUNKS,
+  READERTYPE_SPILL,
+  READERTYPE_SEGMENTS,
+  READERTYPE_SLICE,
+  READERTYPE_CONCAT,
+  READERTYPE_CONCAT_LAZY,
+  READERTYPE_BUFFERED,
+  READERTYPE_CACHE,
   READERTYPE_COUNT
 } ReaderType;
 
@@ -64,14 +85,54 @@ static void *anchor;
 #endif
 static _Optional char *buffer;
 static size_t buffer_size;
+static _Optional Chunks *chunks;
+static _Optional SpillBuf *spill;
+static _Optional ReaderSegment *segs;
+static size_t nsegs;
+static _Optional long int *seg_sizes;
+static _Optional Reader *children;
+static _Optional Reader **child_ptrs;
+static Reader parent;
 static _Optional FILE *f;
 static char file_name[L_tmpnam];
 
+static void make_segments(const void *const data, size_t const size)
+{
+  assert(!buffer);
+  buffer = malloc(size ? size : 1);
+  assert(buffer);
+  buffer_size = size;
+  memcpy(&*buffer, data, size);
+
+  /* Split the data into segments of varying size, some of them empty. */
+  assert(!segs);
+  segs = malloc((size + 1) * sizeof(*segs));
+  assert(segs);
+  nsegs = 0;
+  for (size_t pos = 0; pos < size; ++nsegs) {
+    size_t seg_size = nsegs % ChunkSize;
+    if (seg_size > size - pos) {
+      seg_size = size - pos;
+    }
+    segs[nsegs] = (ReaderSegment){&*buffer + pos, seg_size};
+    pos += seg_size;
+  }
+}
+
+static _Optional Reader *open_child(size_t const index, void *const arg)
+{
+  NOT_USED(arg);
+  assert(children);
+  assert(index < nsegs);
+  return &children[index];
+}
+
 static void make_file(ReaderType const rtype, const void *const data,
                       size_t size, size_t const nmemb)
 {
   switch (rtype) {
   case READERTYPE_RAW:
+  case READERTYPE_BUFFERED:
     tmpnam(file_name);
     f = fopen(file_name, "wb");
     if (f == NULL)
@@ -88,9 +149,15 @@ static void make_file(ReaderType const rtype, const void *const data,
     }
     f = freopen(file_name, "rb", &*f);
     assert(f != NULL);
+
+    if (rtype == READERTYPE_BUFFERED) {
+      /* All buffered readers share one reader of the file */
+      reader_raw_init(&parent, &*f);
+    }
     break;
 
   case READERTYPE_GKEY:
+  case READERTYPE_CACHE:
     tmpnam(file_name);
     f = fopen(file_name, "wb");
     if (f == NULL)
@@ -131,6 +198,11 @@ static void make_file(ReaderType const rtype, const void *const data,
     assert(f != NULL);
     f = freopen(file_name, "rb", &*f);
     assert(f != NULL);
+
+    if (rtype == READERTYPE_CACHE) {
+      /* All caching readers share one decompressor */
+      assert(reader_gkey_init(&parent, HistoryLog2, &*f));
+    }
     break;
 
 #ifdef ACORN_FLEX
@@ -156,6 +228,61 @@ static void make_file(ReaderType const rtype, const void *const data,
     memcpy(&*buffer, data, size);
     break;
 
+  case READERTYPE_CHUNKS:
+    size *= nmemb;
+    assert(!chunks);
+    chunks = chunks_make(ChunkSize);
+    assert(chunks);
+    assert(chunks_write(&*chunks, 0, data, size) == size);
+    break;
+
+  case READERTYPE_SPILL:
+    size *= nmemb;
+    assert(!spill);
+    spill = spillbuf_make(SpillThreshold);
+    assert(spill);
+    assert(spillbuf_write(&*spill, 0, data, size) == size);
+    assert(spillbuf_spilled(&*spill) == (size > SpillThreshold));
+    break;
+
+  case READERTYPE_SEGMENTS:
+    make_segments(data, size * nmemb);
+    break;
+
+  case READERTYPE_CONCAT:
+  case READERTYPE_CONCAT_LAZY:
+    /* Each segment is read by a separate reader, shared by all readers
+       of the concatenated data. */
+    make_segments(data, size * nmemb);
+    assert(!seg_sizes);
+    seg_sizes = malloc((nsegs + 1) * sizeof(*seg_sizes));
+    assert(seg_sizes);
+    assert(!children);
+    children = malloc((nsegs + 1) * sizeof(*children));
+    assert(children);
+    assert(!child_ptrs);
+    child_ptrs = malloc((nsegs + 1) * sizeof(*child_ptrs));
+    assert(child_ptrs);
+    for (size_t i = 0; i < nsegs; ++i) {
+      assert(segs);
+      seg_sizes[i] = (long)segs[i].size;
+      assert(reader_mem_init(&children[i], segs[i].base, segs[i].size));
+      child_ptrs[i] = &children[i];
+    }
+    break;
+
+  case READERTYPE_SLICE:
+    /* Surround the data with padding that mustn't be read via a slice */
+    size *= nmemb;
+    assert(!buffer);
+    buffer = malloc(size + (SliceOffset * 2));
+    assert(buffer);
+    buffer_size = size;
+    memset(&*buffer, Marker, size + (SliceOffset * 2));
+    memcpy(&*buffer + SliceOffset, data, size);
+    assert(reader_mem_init(&parent, &*buffer, size + (SliceOffset * 2)));
+    break;
+
   default:
     abort();
     break;
@@ -181,6 +308,14 @@ static void rewind_file(ReaderType const rtype)
   case READERTYPE_FLEX:
 #endif
   case READERTYPE_MEM:
+  case READERTYPE_CHUNKS:
+  case READERTYPE_SPILL:
+  case READERTYPE_SEGMENTS:
+  case READERTYPE_SLICE:
+  case READERTYPE_CONCAT:
+  case READERTYPE_CONCAT_LAZY:
+  case READERTYPE_BUFFERED:
+  case READERTYPE_CACHE:
     break;
 
   default:
@@ -192,6 +327,11 @@ static void rewind_file(ReaderType const rtype)
 static void delete_file(ReaderType const rtype)
 {
   switch (rtype) {
+  case READERTYPE_BUFFERED:
+  case READERTYPE_CACHE:
+    reader_destroy(&parent);
+    /* fallthrough */
+
   case READERTYPE_RAW:
   case READERTYPE_GKEY:
     assert(f);
@@ -212,6 +352,46 @@ static void delete_file(ReaderType const rtype)
     buffer_size = 0;
     break;
 
+  case READERTYPE_CHUNKS:
+    chunks_destroy(chunks);
+    chunks = NULL;
+    break;
+
+  case READERTYPE_SPILL:
+    spillbuf_destroy(spill);
+    spill = NULL;
+    break;
+
+  case READERTYPE_CONCAT:
+  case READERTYPE_CONCAT_LAZY:
+    for (size_t i = 0; i < nsegs; ++i) {
+      assert(children);
+      reader_destroy(&children[i]);
+    }
+    free(children);
+    children = NULL;
+    free(child_ptrs);
+    child_ptrs = NULL;
+    free(seg_sizes);
+    seg_sizes = NULL;
+    /* fallthrough */
+
+  case READERTYPE_SEGMENTS:
+    free(segs);
+    segs = NULL;
+    nsegs = 0;
+    free(buffer);
+    buffer = NULL;
+    buffer_size = 0;
+    break;
+
+  case READERTYPE_SLICE:
+    reader_destroy(&parent);
+    free(buffer);
+    buffer = NULL;
+    buffer_size = 0;
+    break;
+
   default:
     abort();
     break;
@@ -242,12 +422,88 @@ static void init_reader(ReaderType const rtype, Reader *const r)
     assert(reader_mem_init(r, &*buffer, buffer_size));
     break;
 
+  case READERTYPE_CHUNKS:
+    assert(chunks);
+    reader_chunks_init(r, &*chunks);
+    break;
+
+  case READERTYPE_SPILL:
+    assert(spill);
+    reader_spill_init(r, &*spill);
+    break;
+
+  case READERTYPE_SEGMENTS:
+    assert(segs);
+    assert(reader_segments_init(r, &*segs, nsegs));
+    break;
+
+  case READERTYPE_SLICE:
+    assert(reader_slice_init(r, &parent, SliceOffset, (long)buffer_size));
+    break;
+
+  case READERTYPE_CONCAT:
+    assert(seg_sizes);
+    assert(reader_concat_init(r, nsegs, &*seg_sizes, MaxOpenSources,
+                              open_child, NULL, NULL));
+    break;
+
+  case READERTYPE_CONCAT_LAZY:
+    assert(child_ptrs);
+    assert(reader_concat_init_readers(r, &*child_ptrs, nsegs));
+    break;
+
+  case READERTYPE_BUFFERED:
+    assert(reader_buffered_init(r, &parent, ReadBufferSize));
+    break;
+
+  case READERTYPE_CACHE:
+    assert(reader_cache_init(r, &parent, ChunkSize, ChunkSize * CachePages));
+    break;
+
   default:
     abort();
     break;
   }
 }
 
+static bool can_peek(ReaderType const rtype)
+{
+  bool peek = false;
+
+  switch (rtype) {
+  case READERTYPE_RAW:
+  case READERTYPE_GKEY:
+#ifdef ACORN_FLEX
+  case READERTYPE_FLEX:
+#endif
+  case READERTYPE_CONCAT_LAZY:
+    peek = false;
+    break;
+
+  case READERTYPE_SPILL:
+    /* Only data that hasn't been moved to a file can be peeked */
+    assert(spill);
+    peek = !spillbuf_spilled(&*spill);
+    break;
+
+  case READERTYPE_MEM:
+  case READERTYPE_CHUNKS:
+  case READERTYPE_SEGMENTS:
+  case READERTYPE_SLICE:
+  case READERTYPE_CONCAT:
+  case READERTYPE_BUFFERED:
+  case READERTYPE_CACHE:
+    peek = true;
+    break;
+
+  default:
+    abort();
+    break;
+  }
+
+  return peek;
+}
+
 static void test1(ReaderType const rtype)
 {
   /* Init/term */
@@ -1285,6 +1541,87 @@ static void test31(ReaderType const rtype)
   delete_file(rtype);
 }
 
+static void test32(ReaderType const rtype)
+{
+  /* Peek */
+  Reader r;
+  size_t size;
+  _Optional const char *p;
+
+  make_file_from_string(rtype, TEST_STR);
+  init_reader(rtype, &r);
+
+  while (reader_ftell(&r) < (long)strlen(TEST_STR)) {
+    long int const pos = reader_ftell(&r);
+    p = reader_fpeek(&r, &size);
+    if (!can_peek(rtype)) {
+      assert(p == NULL);
+      assert(size == 0);
+      break;
+    }
+
+    assert(p != NULL);
+    assert(size > 0);
+    assert(size <= strlen(TEST_STR) - (size_t)pos);
+    assert(!memcmp(&*p, TEST_STR + pos, size));
+    assert(reader_ftell(&r) == pos);
+
+    assert(!reader_fseek(&r, (long)size, SEEK_CUR));
+  }
+
+  /* Nothing to peek at the end of the input */
+  assert(!reader_fseek(&r, (long)strlen(TEST_STR), SEEK_SET));
+  p = reader_fpeek(&r, &size);
+  assert(p == NULL);
+  assert(size == 0);
+  assert(!reader_feof(&r));
+  assert(!reader_ferror(&r));
+
+  /* A pushed-back character can't be peeked */
+  assert(!reader_fseek(&r, 0, SEEK_SET));
+  assert(reader_fgetc(&r) == TEST_STR[0]);
+  assert(reader_ungetc(TEST_STR[0], &r) == TEST_STR[0]);
+  p = reader_fpeek(&r, &size);
+  assert(p == NULL);
+  assert(size == 0);
+  assert(reader_fgetc(&r) == TEST_STR[0]);
+
+  reader_destroy(&r);
+
+  delete_file(rtype);
+}
+
+static void test33(ReaderType const rtype)
+{
+  /* Peek long data */
+  Reader r;
+  size_t size;
+  unsigned char data[LongDataSize];
+  for (size_t n = 0; n < sizeof(data); ++n) {
+    data[n] = (unsigned char)rand();
+  }
+  make_file(rtype, data, sizeof(data), 1);
+
+  init_reader(rtype, &r);
+
+  _Optional const unsigned char *const p = reader_fpeek(&r, &size);
+  if (can_peek(rtype)) {
+    assert(p != NULL);
+    assert(size > 0);
+    assert(size <= sizeof(data));
+    assert(!memcmp(&*p, data, size));
+  } else {
+    assert(p == NULL);
+    assert(size == 0);
+  }
+  assert(reader_ftell(&r) == 0);
+  assert(reader_fgetc(&r) == data[0]);
+
+  reader_destroy(&r);
+
+  delete_file(rtype);
+}
+
 static const char *rtype_to_string(ReaderType const rtype)
 {
   const char *s;
@@ -1303,6 +1640,30 @@ static const char *rtype_to_string(ReaderType const rtype)
   case READERTYPE_MEM:
     s = "Mem";
     break;
+  case READERTYPE_CHUNKS:
+    s = "Chunks";
+    break;
+  case READERTYPE_SPILL:
+    s = "Spill";
+    break;
+  case READERTYPE_SEGMENTS:
+    s = "Segments";
+    break;
+  case READERTYPE_SLICE:
+    s = "Slice";
+    break;
+  case READERTYPE_CONCAT:
+    s = "Concat";
+    break;
+  case READERTYPE_CONCAT_LAZY:
+    s = "Concat (lazy)";
+    break;
+  case READERTYPE_BUFFERED:
+    s = "Buffered";
+    break;
+  case READERTYPE_CACHE:
+    s = "Cache";
+    break;
   default:
     s = "Unknown";
     break;
@@ -1347,6 +1708,8 @@ void Reader_tests(void)
     {"Read after seek back fail recovery", test29},
     {"Seek forward far from current", test30},
     {"Seek back far from current", test31},
+    {"Peek", test32},
+    {"Peek long data", test33},
   };
 
   for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
@@ -0,0 +1,272 @@
+/*
+ * StreamLib test: Writer which copies output to other writers
+ * Copyright (C) 2026 Christopher Bazley
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* ISO library headers */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* StreamLib headers */
+#include "ReaderGKey.h"
+#include "ReaderMem.h"
+#include "WriterGKC.h"
+#include "WriterGKey.h"
+#include "WriterHeap.h"
+#include "WriterMem.h"
+#include "WriterTee.h"
+
+/* Local headers */
+#include "Tests.h"
+
+enum {
+  HistoryLog2 = 9,
+  LongDataSize = 1000,
+  SmallBufferSize = 10,
+  NumberOfCopies = 2,
+};
+
+static void make_data(unsigned char *const data)
+{
+  for (size_t i = 0; i < LongDataSize; ++i) {
+    data[i] = (unsigned char)((i * i) % 7);
+  }
+}
+
+static void test1(void)
+{
+  /* Copy compressed output */
+  _Optional void *bufs[NumberOfCopies] = {NULL};
+  Writer heaps[NumberOfCopies];
+  Writer *children[NumberOfCopies];
+  unsigned char data[LongDataSize], rdata[LongDataSize];
+
+  for (size_t i = 0; i < NumberOfCopies; ++i) {
+    assert(writer_heap_init(&heaps[i], &bufs[i], 0));
+    children[i] = &heaps[i];
+  }
+
+  Writer tee, w;
+  assert(writer_tee_init(&tee, children, NumberOfCopies));
+
+  /* The compressor seeks back to patch the header when destroyed */
+  assert(writer_gkey_init_from(&w, HistoryLog2, 0, &tee));
+  make_data(data);
+  assert(writer_fwrite(data, sizeof(data), 1, &w) == 1);
+  assert(writer_destroy(&w) == LongDataSize);
+
+  long int const len = writer_destroy(&tee);
+  assert(len > 0);
+
+  for (size_t i = 0; i < NumberOfCopies; ++i) {
+    assert(writer_destroy(&heaps[i]) == len);
+    assert(bufs[i] != NULL);
+  }
+
+  for (size_t i = 0; i < NumberOfCopies; ++i) {
+    assert(!memcmp((void *)bufs[0], (void *)bufs[i], (size_t)len));
+
+    Reader mem, r;
+    assert(reader_mem_init(&mem, (void *)bufs[i], (size_t)len));
+    assert(reader_gkey_init_from(&r, HistoryLog2, &mem));
+    assert(reader_fread(rdata, sizeof(rdata), 1, &r) == 1);
+    assert(!memcmp(data, rdata, sizeof(data)));
+    assert(reader_fgetc(&r) == EOF);
+    assert(reader_feof(&r));
+    reader_destroy(&r);
+    reader_destroy(&mem);
+  }
+
+  for (size_t i = 0; i < NumberOfCopies; ++i) {
+    free(bufs[i]);
+  }
+}
+
+static void test2(void)
+{
+  /* Compress, copy and estimate in one pass */
+  _Optional void *comp_buf = NULL, *copy_buf = NULL;
+  Writer comp_heap, comp, copy, gkc, tee;
+  long int estimate = -1;
+  unsigned char data[LongDataSize];
+
+  assert(writer_heap_init(&comp_heap, &comp_buf, 0));
+  assert(writer_gkey_init_from(&comp, HistoryLog2, 0, &comp_heap));
+  assert(writer_heap_init(&copy, &copy_buf, 0));
+  assert(writer_gkc_init(&gkc, HistoryLog2, &estimate));
+
+  Writer *const children[] = {&comp, &copy, &gkc};
+  assert(writer_tee_init(&tee, children, ARRAY_SIZE(children)));
+
+  make_data(data);
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    assert(writer_fputc(data[i], &tee) == data[i]);
+  }
+  assert(writer_destroy(&tee) == LongDataSize);
+
+  assert(writer_destroy(&comp) == LongDataSize);
+  long int const comp_len = writer_destroy(&comp_heap);
+  assert(comp_len > 0);
+
+  assert(writer_destroy(&gkc) == LongDataSize);
+  assert(estimate == comp_len);
+
+  assert(writer_destroy(&copy) == LongDataSize);
+  assert(copy_buf != NULL);
+  assert(!memcmp((void *)copy_buf, data, sizeof(data)));
+
+  free(comp_buf);
+  free(copy_buf);
+}
+
+static void test3(void)
+{
+  /* Independent error indicators */
+  _Optional void *buf = NULL;
+  char small[SmallBufferSize];
+  Writer mem, heap, tee;
+  unsigned char data[LongDataSize];
+
+  assert(writer_mem_init(&mem, small, sizeof(small)));
+  assert(writer_heap_init(&heap, &buf, 0));
+
+  Writer *const children[] = {&mem, &heap};
+  assert(writer_tee_init(&tee, children, ARRAY_SIZE(children)));
+
+  make_data(data);
+  assert(writer_fwrite(data, sizeof(data), 1, &tee) == 1);
+  assert(!writer_ferror(&tee));
+  assert(writer_ferror(&mem));
+  assert(!writer_ferror(&heap));
+  assert(writer_ftell(&tee) == LongDataSize);
+  assert(writer_destroy(&tee) == LongDataSize);
+
+  assert(writer_destroy(&mem) == -1);
+  assert(writer_destroy(&heap) == LongDataSize);
+  assert(buf != NULL);
+  assert(!memcmp((void *)buf, data, sizeof(data)));
+  free(buf);
+}
+
+static void test4(void)
+{
+  /* All children failed */
+  char small[SmallBufferSize];
+  Writer mem, tee;
+  unsigned char data[LongDataSize];
+
+  assert(writer_mem_init(&mem, small, sizeof(small)));
+  Writer *const children[] = {&mem};
+  assert(writer_tee_init(&tee, children, ARRAY_SIZE(children)));
+
+  make_data(data);
+  assert(writer_fwrite(data, 1, sizeof(data), &tee) == SmallBufferSize);
+  assert(writer_ferror(&tee));
+  assert(writer_ferror(&mem));
+  assert(writer_destroy(&tee) == -1);
+  assert(writer_destroy(&mem) == -1);
+  assert(!memcmp(small, data, sizeof(small)));
+}
+
+static void test5(void)
+{
+  /* Seek and overwrite */
+  char bufs[NumberOfCopies][SmallBufferSize];
+  Writer mems[NumberOfCopies];
+  Writer *children[NumberOfCopies];
+
+  for (size_t i = 0; i < NumberOfCopies; ++i) {
+    assert(writer_mem_init(&mems[i], bufs[i], sizeof(bufs[i])));
+    children[i] = &mems[i];
+  }
+
+  Writer tee;
+  assert(writer_tee_init(&tee, children, NumberOfCopies));
+  assert(writer_fwrite("qwerty", 6, 1, &tee) == 1);
+  assert(!writer_fseek(&tee, 1, SEEK_SET));
+  assert(writer_fputc('W', &tee) == 'W');
+  assert(!writer_fseek(&tee, 2, SEEK_CUR));
+  assert(writer_fputc('T', &tee) == 'T');
+  assert(writer_destroy(&tee) == 6);
+
+  for (size_t i = 0; i < NumberOfCopies; ++i) {
+    assert(writer_destroy(&mems[i]) == 6);
+    assert(!memcmp(bufs[i], "qWerTy", 6));
+  }
+}
+
+static void test6(void)
+{
+  /* No children */
+  Writer tee;
+  assert(writer_tee_init(&tee, NULL, 0));
+  assert(writer_fwrite("qwerty", 6, 1, &tee) == 1);
+  assert(!writer_ferror(&tee));
+  assert(writer_destroy(&tee) == 6);
+}
+
+static void test7(void)
+{
+  /* Init fail recovery */
+  unsigned long limit;
+  Writer heap;
+  _Optional void *buf = NULL;
+  assert(writer_heap_init(&heap, &buf, 0));
+  Writer *const children[] = {&heap};
+
+  for (limit = 0; limit < 8; ++limit) {
+    Writer tee;
+    Fortify_SetNumAllocationsLimit(limit);
+    bool const ok = writer_tee_init(&tee, children, ARRAY_SIZE(children));
+    Fortify_SetNumAllocationsLimit(ULONG_MAX);
+    if (ok) {
+      assert(writer_destroy(&tee) == 0);
+      break;
+    }
+  }
+  assert(limit != 8);
+
+  assert(writer_destroy(&heap) == 0);
+  free(buf);
+}
+
+void Tee_tests(void)
+{
+  static const struct {
+    const char *test_name;
+    void (*test_func)(void);
+  } unit_tests[] = {
+    {"Copy compressed output", test1},
+    {"Compress, copy and estimate in one pass", test2},
+    {"Independent error indicators", test3},
+    {"All children failed", test4},
+    {"Seek and overwrite", test5},
+    {"No children", test6},
+    {"Init fail recovery", test7},
+  };
+
+  for (size_t count = 0; count < ARRAY_SIZE(unit_tests); count++) {
+    printf("Test %zu/%zu : %s\n", 1 + count, ARRAY_SIZE(unit_tests),
+           unit_tests[count].test_name);
+
+    Fortify_EnterScope();
+    unit_tests[count].test_func();
+    Fortify_LeaveScope();
+  }
+}
@@ -73,6 +73,16 @@ static inline _Optional void *optional_malloc(size_t n)
 #define NOT_USED(x) ((void)(x))
 #define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
 
+extern void Alloc_tests(void);
+extern void GKey_tests(void);
+extern void Heap_tests(void);
+extern void Tee_tests(void);
+extern void Copy_tests(void);
+extern void Cache_tests(void);
+extern void Batch_tests(void);
+#ifdef STREAM_PIPE
+extern void Pipe_tests(void);
+#endif
 extern void Reader_tests(void);
 extern void ReaderNull_tests(void);
 extern void Writer_tests(void);
@@ -28,15 +28,18 @@
 #include "GKeyDecomp.h"
 
 /* StreamLib headers */
+#include "WriterChnk.h"
 #include "WriterGKC.h"
 #include "WriterGKey.h"
 #include "WriterRaw.h"
+#include "WriterSpl.h"
 #ifdef ACORN_FLEX
 #include "WriterFlex.h"
 #endif
 #include "WriterHeap.h"
 #include "WriterMem.h"
 #include "WriterNull.h"
+#include "WriterBuf.h"
 
 /* Local headers */
 #include "Tests.h"
@@ -53,6 +56,8 @@ enum {
   Offset = 2,
   HeadLen = 2,
   TailLen = 1,
+  SpillThreshold = 4,
+  WriteBufferSize = 5,
 };
 
 typedef enum {
@@ -65,12 +70,18 @@ typedef enum {
   WRITERTYPE_MEM,
   WRITERTYPE_HEAP,
   WRITERTYPE_NULL,
+  WRITERTYPE_CHUNKS,
+  WRITERTYPE_SPILL,
+  WRITERTYPE_BUFFERED,
   WRITERTYPE_COUNT
 } WriterType;
 
 static _Optional void *anchors[NumberOfWriters];
 static _Optional void *buffers[NumberOfWriters];
+static _Optional Chunks *chunks[NumberOfWriters];
+static _Optional SpillBuf *spills[NumberOfWriters];
 static _Optional FILE *files[NumberOfWriters];
+static Writer raw_writers[NumberOfWriters];
 static int wnum = 0;
 static char file_names[NumberOfWriters][L_tmpnam];
 static long int out_size;
@@ -83,6 +94,11 @@ static void close_file(WriterType const wtype, int const handle)
   _Optional FILE *const fh = files[handle];
 
   switch (wtype) {
+  case WRITERTYPE_BUFFERED:
+    /* The buffered writer doesn't destroy the writer it wraps */
+    writer_destroy(&raw_writers[handle]);
+    /* fallthrough */
+
   case WRITERTYPE_RAW:
   case WRITERTYPE_GKEY:
     assert(fh);
@@ -99,6 +115,8 @@ static void close_file(WriterType const wtype, int const handle)
   case WRITERTYPE_HEAP:
   case WRITERTYPE_NULL:
   case WRITERTYPE_GKC:
+  case WRITERTYPE_CHUNKS:
+  case WRITERTYPE_SPILL:
     break;
 
   default:
@@ -116,6 +134,7 @@ static void delete_file(WriterType const wtype, int const handle)
   switch (wtype) {
   case WRITERTYPE_RAW:
   case WRITERTYPE_GKEY:
+  case WRITERTYPE_BUFFERED:
     remove(file_names[handle]);
     break;
 
@@ -133,6 +152,16 @@ static void delete_file(WriterType const wtype, int const handle)
     buffers[handle] = NULL;
     break;
 
+  case WRITERTYPE_CHUNKS:
+    chunks_destroy(chunks[handle]);
+    chunks[handle] = NULL;
+    break;
+
+  case WRITERTYPE_SPILL:
+    spillbuf_destroy(spills[handle]);
+    spills[handle] = NULL;
+    break;
+
   case WRITERTYPE_NULL:
   case WRITERTYPE_GKC:
     break;
@@ -156,6 +185,9 @@ static bool file_is_extensible(WriterType const wtype)
   case WRITERTYPE_HEAP:
   case WRITERTYPE_NULL:
   case WRITERTYPE_GKC:
+  case WRITERTYPE_CHUNKS:
+  case WRITERTYPE_SPILL:
+  case WRITERTYPE_BUFFERED:
     is_ext = true;
     break;
 
@@ -188,6 +220,9 @@ static bool trailing_zeros(WriterType const wtype)
   case WRITERTYPE_HEAP:
   case WRITERTYPE_NULL:
   case WRITERTYPE_GKC:
+  case WRITERTYPE_CHUNKS:
+  case WRITERTYPE_SPILL:
+  case WRITERTYPE_BUFFERED:
     trail = false;
     break;
 
@@ -211,6 +246,9 @@ static bool discards_writes(WriterType const wtype)
   case WRITERTYPE_RAW:
   case WRITERTYPE_MEM:
   case WRITERTYPE_HEAP:
+  case WRITERTYPE_CHUNKS:
+  case WRITERTYPE_SPILL:
+  case WRITERTYPE_BUFFERED:
     discards = false;
     break;
 
@@ -244,6 +282,9 @@ static bool can_seek_back(WriterType const wtype)
   case WRITERTYPE_MEM:
   case WRITERTYPE_HEAP:
   case WRITERTYPE_NULL:
+  case WRITERTYPE_CHUNKS:
+  case WRITERTYPE_SPILL:
+  case WRITERTYPE_BUFFERED:
     seek_back = true;
     break;
 
@@ -255,6 +296,37 @@ static bool can_seek_back(WriterType const wtype)
   return seek_back;
 }
 
+static bool can_prepare(WriterType const wtype)
+{
+  bool prepare = false;
+
+  switch (wtype) {
+  case WRITERTYPE_MEM:
+  case WRITERTYPE_HEAP:
+    prepare = true;
+    break;
+
+#ifdef ACORN_FLEX
+  case WRITERTYPE_FLEX:
+#endif
+  case WRITERTYPE_RAW:
+  case WRITERTYPE_GKEY:
+  case WRITERTYPE_GKC:
+  case WRITERTYPE_NULL:
+  case WRITERTYPE_CHUNKS:
+  case WRITERTYPE_SPILL:
+  case WRITERTYPE_BUFFERED:
+    prepare = false;
+    break;
+
+  default:
+    abort();
+    break;
+  }
+
+  return prepare;
+}
+
 static void read_file(WriterType const wtype, void *const data, size_t size,
                       size_t const nmemb, int const handle)
 {
@@ -262,7 +334,8 @@ static void read_file(WriterType const wtype, void *const data, size_t size,
          handle);
 
   switch (wtype) {
-  case WRITERTYPE_RAW: {
+  case WRITERTYPE_RAW:
+  case WRITERTYPE_BUFFERED: {
     FILE *const f = fopen(file_names[handle], "rb");
     if (f == NULL)
       perror("Failed to open file");
@@ -339,6 +412,29 @@ static void read_file(WriterType const wtype, void *const data, size_t size,
     }
     break;
 
+  case WRITERTYPE_CHUNKS: {
+    size *= nmemb;
+    _Optional Chunks *const ch = chunks[handle];
+    assert(ch);
+    assert((unsigned long)chunks_size(&*ch) == size);
+    _Optional void *flat = NULL;
+    assert(chunks_flatten(&*ch, &flat));
+    if (size != 0) {
+      assert(flat);
+      memcpy(data, (void *)flat, size);
+    }
+    free(flat);
+  } break;
+
+  case WRITERTYPE_SPILL: {
+    size *= nmemb;
+    _Optional SpillBuf *const sb = spills[handle];
+    assert(sb);
+    assert((unsigned long)spillbuf_size(&*sb) == size);
+    assert(spillbuf_spilled(&*sb) == (size > SpillThreshold));
+    assert(spillbuf_read(&*sb, 0, data, size) == size);
+  } break;
+
   case WRITERTYPE_NULL:
   case WRITERTYPE_GKC:
     break;
@@ -357,6 +453,7 @@ static int open_file(WriterType const wtype, long int const min_size)
 
   switch (wtype) {
   case WRITERTYPE_RAW:
+  case WRITERTYPE_BUFFERED:
     tmpnam(file_names[wnum]);
     assert(files[wnum] == NULL);
     files[wnum] = fopen(file_names[wnum], "wb");
@@ -394,6 +491,18 @@ static int open_file(WriterType const wtype, long int const min_size)
     }
     break;
 
+  case WRITERTYPE_CHUNKS:
+    assert(!chunks[wnum]);
+    chunks[wnum] = chunks_make(HeadLen);
+    assert(chunks[wnum] != NULL);
+    break;
+
+  case WRITERTYPE_SPILL:
+    assert(!spills[wnum]);
+    spills[wnum] = spillbuf_make(SpillThreshold);
+    assert(spills[wnum] != NULL);
+    break;
+
   case WRITERTYPE_NULL:
   case WRITERTYPE_GKC:
     break;
@@ -455,6 +564,24 @@ static bool init_writer(WriterType const wtype, Writer *const w,
     writer_null_init(w);
     break;
 
+  case WRITERTYPE_CHUNKS: {
+    _Optional Chunks *const ch = chunks[handle];
+    assert(ch);
+    writer_chunks_init(w, &*ch);
+  } break;
+
+  case WRITERTYPE_SPILL: {
+    _Optional SpillBuf *const sb = spills[handle];
+    assert(sb);
+    writer_spill_init(w, &*sb);
+  } break;
+
+  case WRITERTYPE_BUFFERED:
+    assert(fh);
+    writer_raw_init(&raw_writers[handle], &*fh);
+    success = writer_buffered_init(w, &raw_writers[handle], WriteBufferSize);
+    break;
+
   default:
     abort();
     break;
@@ -1436,6 +1563,53 @@ static void test32(WriterType const wtype)
   assert(limit != FortifyAllocationLimit);
 }
 
+static void test33(WriterType const wtype)
+{
+  /* Prepare and commit */
+  enum { Gap = 2, Len = 1 + Gap + TEST_STR_LEN };
+  int handle;
+  {
+    Writer w;
+    handle = open_file_and_init_writer(wtype, &w, Len);
+
+    assert(writer_fputc('y', &w) == 'y');
+    assert(!writer_fseek(&w, Gap, SEEK_CUR));
+
+    size_t size;
+    _Optional void *const ptr = writer_fprepare(&w, TEST_STR_LEN, &size);
+    assert(can_prepare(wtype) == (ptr != NULL));
+    if (ptr != NULL) {
+      assert(size >= (size_t)TEST_STR_LEN);
+      memcpy((void *)ptr, TEST_STR, (size_t)TEST_STR_LEN);
+      assert(writer_ftell(&w) == 1 + Gap);
+      writer_fcommit(&w, (size_t)TEST_STR_LEN);
+    } else {
+      assert(size == 0);
+      assert(writer_fwrite(TEST_STR, TEST_STR_LEN, 1, &w) == 1);
+    }
+    assert(writer_ftell(&w) == Len);
+    assert(!writer_ferror(&w));
+
+    /* Storage can't be made bigger than a fixed buffer */
+    assert((writer_fprepare(&w, 1, &size) != NULL) ==
+           (can_prepare(wtype) && file_is_extensible(wtype)));
+
+    destroy_and_check(wtype, &w, Len);
+  }
+  close_file(wtype, handle);
+
+  if (!discards_writes(wtype)) {
+    char buf[Len];
+    read_file(wtype, buf, sizeof(buf[0]), ARRAY_SIZE(buf), handle);
+    assert(buf[0] == 'y');
+    for (size_t n = 1; n <= Gap; ++n) {
+      assert(buf[n] == 0);
+    }
+    assert(!memcmp(buf + 1 + Gap, TEST_STR, (size_t)TEST_STR_LEN));
+  }
+  delete_file(wtype, handle);
+}
+
 static const char *wtype_to_string(WriterType const wtype)
 {
   const char *s;
@@ -1463,6 +1637,15 @@ static const char *wtype_to_string(WriterType const wtype)
   case WRITERTYPE_NULL:
     s = "Null";
     break;
+  case WRITERTYPE_CHUNKS:
+    s = "Chunks";
+    break;
+  case WRITERTYPE_SPILL:
+    s = "Spill";
+    break;
+  case WRITERTYPE_BUFFERED:
+    s = "Buffered";
+    break;
   default:
     s = "Unknown";
     break;
@@ -1506,6 +1689,7 @@ void Writer_tests(void)
     {"Seek forward far from current", test30},
     {"Init fail recovery", test31},
     {"Destroy fail recovery", test32},
+    {"Prepare and commit", test33},
   };
 
   /* Due to a static initialization bug in gcc, zero-initialization
@@ -1513,6 +1697,8 @@ void Writer_tests(void)
   for (size_t i = 0; i < NumberOfWriters; ++i) {
     anchors[i] = NULL;
     buffers[i] = NULL;
+    chunks[i] = NULL;
+    spills[i] = NULL;
     files[i] = NULL;
   }
 